@@ -0,0 +1,34 @@
+# The front end except main(), shared by the dsa1 app and the UI harness.
+# Include after core.pri.
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+SOURCES += \
+    $$PWD/diagnostics_page.cpp \
+    $$PWD/identify_skin_type.cpp \
+    $$PWD/image_service.cpp \
+    $$PWD/mainwindow.cpp \
+    $$PWD/order_history_model.cpp \
+    $$PWD/page_manager.cpp \
+    $$PWD/product_table_model.cpp \
+    $$PWD/search_panel.cpp \
+    $$PWD/theme.cpp \
+    $$PWD/thumbnail_cache.cpp
+
+HEADERS += \
+    $$PWD/diagnostics_page.h \
+    $$PWD/identify_skin_type.h \
+    $$PWD/image_service.h \
+    $$PWD/mainwindow.h \
+    $$PWD/order_history_model.h \
+    $$PWD/page_manager.h \
+    $$PWD/product_table_model.h \
+    $$PWD/search_panel.h \
+    $$PWD/theme.h \
+    $$PWD/thumbnail_cache.h
+
+FORMS += \
+    $$PWD/mainwindow.ui
+
+RESOURCES += \
+    $$PWD/resources.qrc
@@ -0,0 +1,130 @@
+#include "diagnostics_page.h"
+#include "metrics.h"
+#include <QFile>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QLabel>
+#include <QLocale>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QVBoxLayout>
+
+namespace {
+
+QString formatDuration(double nanoseconds) {
+    if (nanoseconds < 1e3) return QString("%1 ns").arg(nanoseconds, 0, 'f', 0);
+    if (nanoseconds < 1e6) return QString("%1 us").arg(nanoseconds / 1e3, 0, 'f', 1);
+    if (nanoseconds < 1e9) return QString("%1 ms").arg(nanoseconds / 1e6, 0, 'f', 1);
+    return QString("%1 s").arg(nanoseconds / 1e9, 0, 'f', 2);
+}
+
+QTableWidget* makeTable(const QStringList& headers, QWidget* parent) {
+    QTableWidget* table = new QTableWidget(0, headers.size(), parent);
+    table->setHorizontalHeaderLabels(headers);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->verticalHeader()->hide();
+    table->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    return table;
+}
+
+void setRow(QTableWidget* table, int row, const QStringList& cells) {
+    for (int column = 0; column < cells.size(); ++column) {
+        QTableWidgetItem* item = new QTableWidgetItem(cells[column]);
+        if (column > 0) item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+        table->setItem(row, column, item);
+    }
+}
+
+}
+
+DiagnosticsPage::DiagnosticsPage(function<vector<MemoryUsage>()> memory, QWidget* parent)
+    : QWidget(parent), memory(move(memory)) {
+    QLabel* title = new QLabel(tr("Diagnostics"), this);
+    title->setProperty("role", "title");
+    title->setAlignment(Qt::AlignCenter);
+
+    latencyTable = makeTable({tr("Operation"), tr("Count"), tr("p50"), tr("p99"), tr("Max"), tr("Mean")}, this);
+    memoryTable = makeTable({tr("Data structure"), tr("Items"), tr("Memory")}, this);
+
+    QPushButton* refreshButton = new QPushButton(tr("Refresh"), this);
+    QPushButton* resetButton = new QPushButton(tr("Reset Timings"), this);
+    QPushButton* saveButton = new QPushButton(tr("Save as JSON..."), this);
+    connect(refreshButton, &QPushButton::clicked, this, &DiagnosticsPage::refresh);
+    connect(resetButton, &QPushButton::clicked, this, &DiagnosticsPage::resetLatencies);
+    connect(saveButton, &QPushButton::clicked, this, &DiagnosticsPage::saveJson);
+
+    QHBoxLayout* buttons = new QHBoxLayout;
+    buttons->addWidget(refreshButton);
+    buttons->addWidget(resetButton);
+    buttons->addWidget(saveButton);
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->addWidget(title);
+    layout->addWidget(latencyTable, 3);
+    layout->addWidget(memoryTable, 1);
+    layout->addLayout(buttons);
+}
+
+void DiagnosticsPage::refresh() {
+    vector<LatencyHistogram*> histograms = Metrics::histograms();
+    latencyTable->setRowCount(static_cast<int>(histograms.size()));
+    for (int row = 0; row < latencyTable->rowCount(); ++row) {
+        const LatencyHistogram& h = *histograms[row];
+        setRow(latencyTable, row, {QString::fromStdString(h.name()), QString::number(h.count()),
+                                   formatDuration(h.percentile(0.5)), formatDuration(h.percentile(0.99)),
+                                   formatDuration(h.max()), formatDuration(h.mean())});
+    }
+
+    QLocale locale;
+    vector<MemoryUsage> usage = memory();
+    memoryTable->setRowCount(static_cast<int>(usage.size()));
+    for (int row = 0; row < memoryTable->rowCount(); ++row) {
+        setRow(memoryTable, row, {usage[row].name, QString::number(usage[row].items),
+                                  locale.formattedDataSize(static_cast<qint64>(usage[row].bytes))});
+    }
+}
+
+QJsonDocument DiagnosticsPage::toJson() const {
+    QJsonArray latencies;
+    for (const LatencyHistogram* h : Metrics::histograms()) {
+        QJsonObject entry;
+        entry["name"] = QString::fromStdString(h->name());
+        entry["count"] = static_cast<qint64>(h->count());
+        entry["p50_ns"] = static_cast<qint64>(h->percentile(0.5));
+        entry["p99_ns"] = static_cast<qint64>(h->percentile(0.99));
+        entry["max_ns"] = static_cast<qint64>(h->max());
+        entry["mean_ns"] = h->mean();
+        latencies.append(entry);
+    }
+    QJsonArray structures;
+    for (const MemoryUsage& usage : memory()) {
+        QJsonObject entry;
+        entry["name"] = usage.name;
+        entry["items"] = static_cast<qint64>(usage.items);
+        entry["bytes"] = static_cast<qint64>(usage.bytes);
+        structures.append(entry);
+    }
+    QJsonObject root;
+    root["latencies"] = latencies;
+    root["memory"] = structures;
+    return QJsonDocument(root);
+}
+
+void DiagnosticsPage::saveJson() {
+    QString path = QFileDialog::getSaveFileName(this, tr("Save Diagnostics"), "diagnostics.json", tr("JSON files (*.json)"));
+    if (path.isEmpty()) return;
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(toJson().toJson()) < 0) {
+        QMessageBox::warning(this, tr("Save Diagnostics"), tr("Unable to write %1.").arg(path));
+    }
+}
+
+void DiagnosticsPage::resetLatencies() {
+    Metrics::resetAll();
+    refresh();
+}
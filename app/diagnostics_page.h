@@ -0,0 +1,43 @@
+#ifndef DIAGNOSTICS_PAGE_H
+#define DIAGNOSTICS_PAGE_H
+
+#include <QJsonDocument>
+#include <QString>
+#include <QWidget>
+#include <functional>
+#include <vector>
+
+using namespace std;
+
+class QTableWidget;
+
+// Memory held by one of the window's data structures
+struct MemoryUsage {
+    QString name;
+    size_t items;
+    size_t bytes;
+};
+
+// Staff page with the latency histograms recorded through Metrics (count,
+// p50, p99, max and mean per operation) and the memory held by each data
+// structure. Everything on it can be saved as JSON.
+class DiagnosticsPage : public QWidget {
+    Q_OBJECT
+
+public:
+    // memory is asked for the current figures on every refresh
+    explicit DiagnosticsPage(function<vector<MemoryUsage>()> memory, QWidget* parent = nullptr);
+
+    void refresh();
+    QJsonDocument toJson() const;
+
+private:
+    function<vector<MemoryUsage>()> memory;
+    QTableWidget* latencyTable;
+    QTableWidget* memoryTable;
+
+    void saveJson();
+    void resetLatencies();
+};
+
+#endif // DIAGNOSTICS_PAGE_H
@@ -17,9 +17,6 @@ void identifySkinType(QWidget *parent) {
     dialog.setWindowTitle(QObject::tr("Identify Skin Type"));
     QFormLayout form(&dialog);
 
-    // Set the background color to light red
-    dialog.setStyleSheet("background-color: #FFCDD2;");
-
     QStringList questions = {
         "Do you notice that your skin tends to appear shiny or greasy, especially in T-Zone area (forehead, nose, and chin)?",
         "Do your skin feel slick or oily to the touch, even shortly after washing your face?",
@@ -0,0 +1,106 @@
+#include "image_service.h"
+#include "log.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QLabel>
+#include <QPixmap>
+#include <QPixmapCache>
+
+namespace {
+
+LogCategory logImages("images");
+
+}
+
+ImageService::ImageService(QObject* parent) : QObject(parent) {
+    // Decoding is I/O and memory bound; two workers are plenty for assets
+    pool.setMaxThreadCount(2);
+}
+
+ImageService::~ImageService() {
+    pool.waitForDone();
+}
+
+QString ImageService::resolvePath(const QString& name) {
+    QString local = QDir(QCoreApplication::applicationDirPath()).filePath(name);
+    if (QFileInfo::exists(local)) return local;
+    QString resource = QStringLiteral(":/images/") + name;
+    if (QFileInfo::exists(resource)) return resource;
+    return QString();
+}
+
+QImage ImageService::decodeScaled(const QString& path, const QSize& bounds) {
+    QImageReader reader(path);
+    reader.setAutoTransform(true);
+    QSize size = reader.size();
+    if (size.isValid()) {
+        // Let the decoder scale, which for JPEG skips most of the full-size work
+        reader.setScaledSize(size.scaled(bounds, Qt::KeepAspectRatio));
+    }
+    QImage image = reader.read();
+    if (image.isNull()) {
+        LOG_WARNING(logImages) << "Unable to decode " << path.toStdString() << ": " << reader.errorString().toStdString();
+    } else if (!size.isValid()) {
+        image = image.scaled(bounds, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+    return image;
+}
+
+QString ImageService::cacheKey(const QString& path, const QSize& bounds) {
+    return QStringLiteral("%1@%2x%3").arg(path).arg(bounds.width()).arg(bounds.height());
+}
+
+QPixmap ImageService::placeholder(const QSize& bounds) {
+    QString key = cacheKey(QStringLiteral("placeholder"), bounds);
+    QPixmap pixmap;
+    if (!QPixmapCache::find(key, &pixmap)) {
+        pixmap = QPixmap(bounds);
+        pixmap.fill(QColor(0xF8, 0xBB, 0xD0));
+        QPixmapCache::insert(key, pixmap);
+    }
+    return pixmap;
+}
+
+void ImageService::loadInto(QLabel* label, const QString& name, const QSize& bounds) {
+    QString path = resolvePath(name);
+    if (path.isEmpty()) {
+        LOG_WARNING(logImages) << "Image not found: " << name.toStdString();
+        label->setPixmap(placeholder(bounds));
+        return;
+    }
+
+    QString key = cacheKey(path, bounds);
+    QPixmap pixmap;
+    if (QPixmapCache::find(key, &pixmap)) {
+        label->setPixmap(pixmap);
+        return;
+    }
+
+    label->setPixmap(placeholder(bounds));
+    bool decoding = waiting.contains(key);
+    waiting[key].append(QPointer<QLabel>(label));
+    if (decoding) return;
+
+    pool.start([this, path, bounds]() {
+        QImage image = decodeScaled(path, bounds);
+        // QPixmaps can only be made on the GUI thread
+        QMetaObject::invokeMethod(this, [this, path, bounds, image]() { finish(path, bounds, image); }, Qt::QueuedConnection);
+    });
+}
+
+void ImageService::finish(const QString& path, const QSize& bounds, const QImage& image) {
+    QString key = cacheKey(path, bounds);
+    QList<QPointer<QLabel>> labels = waiting.take(key);
+    if (image.isNull()) return;
+
+    QPixmap pixmap = QPixmap::fromImage(image);
+    QPixmapCache::insert(key, pixmap);
+    for (const QPointer<QLabel>& label : labels) {
+        if (label) {
+            label->setPixmap(pixmap);
+        }
+    }
+    emit imageReady(path, bounds);
+}
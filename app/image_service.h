@@ -0,0 +1,52 @@
+#ifndef IMAGE_SERVICE_H
+#define IMAGE_SERVICE_H
+
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QSize>
+#include <QString>
+#include <QThreadPool>
+
+class QLabel;
+class QPixmap;
+
+// Loads image assets without blocking the GUI thread. Files are decoded and
+// scaled on a worker thread with QImageReader, which can downscale while
+// decoding. Scaled results are kept in QPixmapCache keyed by path and size,
+// so each size of an asset is decoded once per session.
+class ImageService : public QObject {
+    Q_OBJECT
+
+public:
+    explicit ImageService(QObject* parent = nullptr);
+    // Waits for decodes still running
+    ~ImageService();
+
+    // Finds an asset next to the executable, falling back to the copy
+    // compiled in from resources.qrc. Returns an empty string if neither exists.
+    static QString resolvePath(const QString& name);
+    // Decodes path scaled to fit within bounds, keeping its aspect ratio.
+    // Runs on the calling thread; returns a null image on failure.
+    static QImage decodeScaled(const QString& path, const QSize& bounds);
+
+    // Shows the asset in label: straight from the cache when it is there,
+    // otherwise a placeholder until the worker thread has decoded it
+    void loadInto(QLabel* label, const QString& name, const QSize& bounds);
+
+signals:
+    void imageReady(const QString& path, const QSize& bounds);
+
+private:
+    QThreadPool pool;
+    // Labels waiting for each cache key being decoded
+    QHash<QString, QList<QPointer<QLabel>>> waiting;
+
+    static QString cacheKey(const QString& path, const QSize& bounds);
+    static QPixmap placeholder(const QSize& bounds);
+    void finish(const QString& path, const QSize& bounds, const QImage& image);
+};
+
+#endif // IMAGE_SERVICE_H
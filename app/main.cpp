@@ -0,0 +1,34 @@
+#include "mainwindow.h"
+#include "catalog_snapshot.h"
+#include "theme.h"
+#include "trace.h"
+#include <QApplication>
+#include <iostream>
+
+using namespace std;
+
+int main(int argc, char *argv[]) {
+    // dsa1 --convert-catalog <input> <output> converts between products.txt and products.bin
+    if (argc == 4 && string(argv[1]) == "--convert-catalog") {
+        bool converted = convertCatalog(argv[2], argv[3]);
+        cerr << (converted ? "Catalog converted." : "Catalog conversion failed.") << endl;
+        return converted ? 0 : 1;
+    }
+
+    // DSA1_TRACE=<file> traces the whole session, startup included, into file
+    QByteArray tracePath = qgetenv("DSA1_TRACE");
+    if (!tracePath.isEmpty()) {
+        Trace::start();
+    }
+    Trace::setThreadName("GUI");
+
+    QApplication a(argc, argv);
+    applyTheme(a);
+    MainWindow w;
+    w.show();
+    int result = a.exec();
+    if (!tracePath.isEmpty()) {
+        Trace::writeChromeJson(tracePath.toStdString());
+    }
+    return result;
+}
@@ -0,0 +1,1000 @@
+#include "mainwindow.h"
+#include "identify_skin_type.h"
+#include "taxonomy.h"
+#include "catalog_snapshot.h"
+#include "log.h"
+#include "metrics.h"
+#include "order_log.h"
+#include "product_table_model.h"
+#include "order_history_model.h"
+#include "search_panel.h"
+#include "diagnostics_page.h"
+#include <QApplication>
+#include <QInputDialog>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QLabel>
+#include <QPixmap>
+#include <QVBoxLayout>
+#include <QTextEdit>
+#include <fstream>
+#include <QUrl>
+#include <numeric>
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <QHBoxLayout>
+#include <QSpinBox>
+#include <QFormLayout>
+#include <QCheckBox>
+#include <QDialogButtonBox>
+#include <QScrollArea>
+#include <QStatusBar>
+#include <QTableView>
+#include <QHeaderView>
+#include <QStackedWidget>
+#include <QDateEdit>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileDialog>
+
+using namespace std;
+
+static QStringList toStringList(const vector<string>& values) {
+    QStringList list;
+    for (const string& value : values) {
+        list << QString::fromStdString(value);
+    }
+    return list;
+}
+
+// MainWindow class implementation
+MainWindow::MainWindow(QWidget *parent)
+    : QMainWindow(parent), catalogSearch(products), catalogLog(persistence, "products.bin", "products.log", "products.txt"), isCurrentUserStaff(false),
+      pages(nullptr), thumbnails(QSize(48, 48), 32 * 1024 * 1024), productModel(nullptr), searchPanel(nullptr), cartText(nullptr), orderModel(nullptr), orderDetails(nullptr), diagnostics(nullptr),
+      loadedStores(0), ordersLoading(false) {
+    thumbnails.setDiskCacheDirectory("thumbnails");
+    // The writer thread emits these; queue them onto the GUI thread
+    connect(&persistence, &PersistenceService::catalogSaved, this, &MainWindow::onCatalogSaved, Qt::QueuedConnection);
+    connect(&persistence, &PersistenceService::writeFailed, this, &MainWindow::onWriteFailed, Qt::QueuedConnection);
+
+    // Every screen lives in one stack and is built on first use
+    QStackedWidget *pageStack = new QStackedWidget(this);
+    setCentralWidget(pageStack);
+    pages = new PageManager(pageStack, this);
+    pages->addPage(PageManager::MainPage, [this]() { return buildMainPage(); });
+    pages->addPage(PageManager::LoginPage, [this]() { return buildLoginScreen(); });
+    pages->addPage(PageManager::StaffMenuPage, [this]() { return buildStaffMenu(); });
+    pages->addPage(PageManager::CustomerMenuPage, [this]() { return buildCustomerMenu(); });
+    pages->addPage(PageManager::ProductsPage, [this]() { return buildProductsPage(); }, [this]() { runSearch(); });
+    pages->addPage(PageManager::CartPage, [this]() { return buildCartPage(); }, [this]() { refreshCart(); });
+    pages->addPage(PageManager::OrdersPage, [this]() { return buildOrdersPage(); }, [this]() { refreshOrders(); });
+    pages->addPage(PageManager::DiagnosticsPage, [this]() { return buildDiagnosticsPage(); }, [this]() { diagnostics->refresh(); });
+    pages->setHome([this]() {
+        if (currentUser.username.empty()) return PageManager::MainPage;
+        return isCurrentUserStaff ? PageManager::StaffMenuPage : PageManager::CustomerMenuPage;
+    });
+
+    // The first frame doesn't wait for any data
+    showMainPage();
+    startLoading();
+}
+
+MainWindow::~MainWindow() {
+    // The loaders write through catalogLog and persistence
+    loaders.waitForDone();
+}
+
+void MainWindow::on_registerButton_clicked() {
+    SCOPED_LATENCY("MainWindow::on_registerButton_clicked");
+    if (!isLoaded(Users)) return;
+    bool ok;
+    QString username = QInputDialog::getText(this, tr("Register"),
+                                             tr("Username:"), QLineEdit::Normal,
+                                             "", &ok);
+    if (!ok || username.isEmpty()) return;
+    if (users.findUser(username.toStdString())) {
+        QMessageBox::warning(this, tr("Register"), tr("Username is already taken."));
+        return;
+    }
+
+    QString password;
+    while (true) {
+        password = QInputDialog::getText(this, tr("Register"),
+                                         tr("Password (at least 8 characters):"), QLineEdit::Password,
+                                         "", &ok);
+        if (!ok) return;
+        if (password.length() >= 8) break;
+        QMessageBox::warning(this, tr("Register"), tr("Password must be at least 8 characters long."));
+    }
+
+    bool isStaff = QMessageBox::question(this, tr("Register"), tr("Is Staff?"), QMessageBox::Yes | QMessageBox::No) == QMessageBox::Yes;
+
+    if (isStaff) {
+        QString staffCode = QInputDialog::getText(this, tr("Register"),
+                                                  tr("Enter Staff Code:"), QLineEdit::Normal,
+                                                  "", &ok);
+        if (!ok || (staffCode != "mahvil" && staffCode != "ayesha")) {
+            QMessageBox::warning(this, tr("Register"), tr("Invalid staff code. Registering as customer."));
+            isStaff = false;
+        }
+    }
+
+    User user(username.toStdString(), password.toStdString(), isStaff);
+    if (!users.addUser(user)) return;
+    saveUserToFile(user);
+
+    QMessageBox::information(this, tr("Register"), tr("User registered successfully!"));
+}
+
+void MainWindow::on_loginButton_clicked() {
+    SCOPED_LATENCY("MainWindow::on_loginButton_clicked");
+    if (!isLoaded(Users)) return;
+    bool ok;
+    QString username = QInputDialog::getText(this, tr("Login"),
+                                             tr("Username:"), QLineEdit::Normal,
+                                             "", &ok);
+    if (!ok || username.isEmpty()) return;
+
+    QString password = QInputDialog::getText(this, tr("Login"),
+                                             tr("Password:"), QLineEdit::Password,
+                                             "", &ok);
+    if (!ok || password.isEmpty()) return;
+
+    User* user = users.findUser(username.toStdString());
+    if (user && user->password == password.toStdString()) {
+        QMessageBox::information(this, tr("Login"), tr("Login successful!"));
+        currentUser = *user;
+        isCurrentUserStaff = currentUser.isStaff;
+        if (currentUser.isStaff) {
+            showStaffMenu();
+        } else {
+            showCustomerMenu();
+        }
+    } else {
+        QMessageBox::warning(this, tr("Login"), tr("Invalid username or password!"));
+    }
+}
+
+void MainWindow::on_addProductButton_clicked() {
+    SCOPED_LATENCY("MainWindow::on_addProductButton_clicked");
+    if (!isLoaded(Products)) return;
+    bool ok;
+    int code = QInputDialog::getInt(this, tr("Add Product"), tr("Product Code:"), 0, 0, 10000, 1, &ok);
+    if (!ok) return;
+
+    QString name = QInputDialog::getText(this, tr("Add Product"), tr("Product Name:"), QLineEdit::Normal, "", &ok);
+    if (!ok || name.isEmpty()) return;
+
+    QString category = QInputDialog::getItem(this, tr("Add Product"), tr("Category:"), toStringList(Taxonomy::instance().categoryNames()), 0, false, &ok);
+    if (!ok || category.isEmpty()) return;
+
+    QStringList subCategories = toStringList(Taxonomy::instance().subCategoryNames(category.toStdString()));
+
+    QString subCategory = QInputDialog::getItem(this, tr("Add Product"), tr("SubCategory:"), subCategories, 0, false, &ok);
+    if (!ok || subCategory.isEmpty()) return;
+
+    QString skinType = QInputDialog::getItem(this, tr("Add Product"), tr("Skin Type:"), toStringList(Taxonomy::instance().skinTypeNames()), 0, false, &ok);
+    if (!ok || skinType.isEmpty()) return;
+
+    QString range = QInputDialog::getItem(this, tr("Add Product"), tr("Price Range:"), toStringList(Taxonomy::instance().rangeNames()), 0, false, &ok);
+    if (!ok || range.isEmpty()) return;
+
+    double price = QInputDialog::getDouble(this, tr("Add Product"), tr("Price:"), 0, 0, 10000, 2, &ok);
+    if (!ok) return;
+
+    int quantity = QInputDialog::getInt(this, tr("Add Product"), tr("Quantity:"), 0, 0, 1000, 1, &ok);
+    if (!ok) return;
+
+    QString imagePath = QInputDialog::getText(this, tr("Add Product"), tr("Image Path (optional):"), QLineEdit::Normal, "", &ok);
+    if (!ok) return;
+
+    Product product(code, name.toStdString(), category.toStdString(), subCategory.toStdString(), skinType.toStdString(), range.toStdString(), price, quantity);
+    product.imagePath = imagePath.trimmed().toStdString();
+    products.addProduct(product);
+    catalogLog.recordAdd(product);
+    compactCatalogIfNeeded();
+
+    QMessageBox::information(this, tr("Add Product"), tr("Product added successfully!"));
+}
+
+void MainWindow::on_editProductQuantityButton_clicked() {
+    SCOPED_LATENCY("MainWindow::on_editProductQuantityButton_clicked");
+    if (!isLoaded(Products)) return;
+    editProductQuantity();
+}
+
+void MainWindow::on_deleteProductButton_clicked() {
+    SCOPED_LATENCY("MainWindow::on_deleteProductButton_clicked");
+    if (!isLoaded(Products)) return;
+    deleteProduct();
+}
+
+void MainWindow::on_displayProductsButton_clicked() {
+    SCOPED_LATENCY("MainWindow::on_displayProductsButton_clicked");
+    if (!isLoaded(Products)) return;
+    displayProducts(currentUser.isStaff);
+}
+
+void MainWindow::on_searchProductsButton_clicked() {
+    SCOPED_LATENCY("MainWindow::on_searchProductsButton_clicked");
+    if (!isLoaded(Products)) return;
+    searchProducts();
+}
+
+void MainWindow::on_viewOrdersButton_clicked() {
+    SCOPED_LATENCY("MainWindow::on_viewOrdersButton_clicked");
+    viewOrders();
+}
+
+void MainWindow::on_viewCartButton_clicked() {
+    SCOPED_LATENCY("MainWindow::on_viewCartButton_clicked");
+    viewCart();
+}
+
+void MainWindow::on_identifySkinTypeButton_clicked() {
+    SCOPED_LATENCY("MainWindow::on_identifySkinTypeButton_clicked");
+    identifySkinType(this);
+}
+
+void MainWindow::on_logoutButton_clicked() {
+    SCOPED_LATENCY("MainWindow::on_logoutButton_clicked");
+    currentUser = User();
+    isCurrentUserStaff = false;
+    showMainPage();
+}
+
+void MainWindow::saveUserToFile(const User& user) {
+    SCOPED_LATENCY("MainWindow::saveUserToFile");
+    string record;
+    user.serializeTo(record);
+    LOG_DEBUG(logUsers) << "User saved to file: " << user.username;
+    persistence.append("users.txt", move(record));
+}
+
+void MainWindow::loadUsersFromFile(UserList& loaded) {
+    SCOPED_LATENCY("MainWindow::loadUsersFromFile");
+    ifstream file("users.txt");
+    string line;
+    User user;
+    while (getline(file, line)) {
+        ParseError error = User::parse(line, user);
+        if (error != ParseError::None) {
+            LOG_WARNING(logUsers) << "Error deserializing user: " << parseErrorMessage(error);
+            continue;
+        }
+        if (!loaded.addUser(user)) {
+            LOG_DEBUG(logUsers) << "Duplicate user skipped: " << user.username;
+            continue;
+        }
+        LOG_VERBOSE(logUsers) << "User loaded from file: " << user.username;
+    }
+    file.close();
+    UserList::Stats stats = loaded.stats();
+    LOG_INFO(logUsers) << "Users loaded: " << stats.size << " load factor: " << stats.loadFactor
+                       << " average probe length: " << stats.averageProbeLength << " max probe length: " << stats.maxProbeLength;
+}
+
+// Rewrites the full catalog snapshot; individual changes go to the catalog log
+void MainWindow::saveProductsToFile() {
+    SCOPED_LATENCY("MainWindow::saveProductsToFile");
+    catalogLog.compact(products);
+}
+
+void MainWindow::loadProductsFromFile(ProductBST& loaded) {
+    SCOPED_LATENCY("MainWindow::loadProductsFromFile");
+    catalogLog.load(loaded);
+}
+
+void MainWindow::compactCatalogIfNeeded() {
+    if (catalogLog.needsCompaction(products.size())) {
+        saveProductsToFile();
+    }
+}
+
+void MainWindow::saveOrderToFile(const Order& order) {
+    SCOPED_LATENCY("MainWindow::saveOrderToFile");
+    string record;
+    OrderLogWriter::frameTo(record, order);
+    persistence.append("orders.log", move(record), OrderLogWriter::header());
+    LOG_DEBUG(logOrders) << "Order saved to file: " << order.customerName;
+}
+
+void MainWindow::onCatalogSaved(bool ok) {
+    if (ok) {
+        statusBar()->showMessage(tr("Catalog saved"), 3000);
+    }
+}
+
+void MainWindow::onWriteFailed(const QString& path) {
+    QMessageBox::warning(this, tr("Save"), tr("Unable to write %1. Recent changes may not have been saved.").arg(path));
+}
+
+void MainWindow::loadOrdersFromFile(OrderLogReader& reader, OrderQueue& loaded) {
+    SCOPED_LATENCY("MainWindow::loadOrdersFromFile");
+    Order order;
+    while (reader.next(order)) {
+        LOG_VERBOSE(logOrders) << "Order loaded from file: " << order.customerName;
+        loaded.enqueue(move(order));
+    }
+    if (reader.corrupt()) {
+        LOG_ERROR(logOrders) << "orders.log is damaged; orders in the damaged records were lost";
+    }
+}
+
+// Users and products are loaded on worker threads into stores of their own,
+// which are swapped in on the GUI thread; until then the features that need
+// them stay disabled
+void MainWindow::startLoading() {
+    loaders.start([this]() {
+        // Checkout needs a login, so no new order reaches orders.log before
+        // the legacy ones have been migrated
+        migrateLegacyOrders("orders.txt", "orders.log");
+        auto loaded = make_shared<UserList>();
+        loadUsersFromFile(*loaded);
+        QMetaObject::invokeMethod(this, [this, loaded]() {
+            users = move(*loaded);
+            finishLoading(Users);
+        }, Qt::QueuedConnection);
+    });
+    loaders.start([this]() {
+        auto loaded = make_shared<ProductBST>();
+        loadProductsFromFile(*loaded);
+        QMetaObject::invokeMethod(this, [this, loaded]() {
+            products.swap(*loaded);
+            finishLoading(Products);
+        }, Qt::QueuedConnection);
+    });
+}
+
+// Starts loading the order history the first time it is needed
+void MainWindow::loadOrderHistory() {
+    if (ordersLoading || isLoaded(Orders)) return;
+    // The loader reads the log as it is now. Orders placed from here on are
+    // still written at checkout, past that point, and are kept in memory too.
+    persistence.flush();
+    uint64_t logSize = static_cast<uint64_t>(qMax<qint64>(QFileInfo("orders.log").size(), 0));
+    ordersLoading = true;
+    statusBar()->showMessage(tr("Loading order history..."));
+    loaders.start([this, logSize]() {
+        auto reader = make_shared<OrderLogReader>("orders.log", logSize);
+        auto loaded = make_shared<OrderQueue>();
+        loadOrdersFromFile(*reader, *loaded);
+        QMetaObject::invokeMethod(this, [this, reader, loaded]() {
+            orders = move(*loaded);
+            ordersLoading = false;
+            if (ordersPlacedWhileLoading.empty()) {
+                // Only checkouts append to the log, so nothing is writing to it now
+                reader->truncateTornTail();
+            }
+            for (Order& order : ordersPlacedWhileLoading) {
+                orders.enqueue(move(order));
+            }
+            ordersPlacedWhileLoading.clear();
+            statusBar()->clearMessage();
+            finishLoading(Orders);
+            if (orderModel) {
+                refreshOrders();
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+void MainWindow::finishLoading(Store store) {
+    loadedStores |= store;
+    emit storeLoaded(store);
+}
+
+// Keeps button disabled until store has loaded
+void MainWindow::enableWhenLoaded(QPushButton* button, Store store) {
+    if (isLoaded(store)) return;
+    button->setEnabled(false);
+    connect(this, &MainWindow::storeLoaded, button, [button, store](Store loaded) {
+        if (loaded == store) button->setEnabled(true);
+    });
+}
+
+
+void MainWindow::displayProducts(bool isStaff) {
+    if (searchPanel) {
+        searchPanel->clear();
+    }
+    pages->show(PageManager::ProductsPage);
+}
+
+// Only the visible rows of the table are ever painted
+QWidget* MainWindow::buildProductsPage() {
+    QWidget *widget = new QWidget;
+    QVBoxLayout *layout = new QVBoxLayout(widget);
+
+    searchPanel = new SearchPanel(widget);
+    connect(searchPanel, &SearchPanel::queryChanged, this, &MainWindow::runSearch);
+    layout->addWidget(searchPanel);
+
+    productModel = new ProductTableModel(widget);
+    productModel->setThumbnails(&thumbnails);
+    ProductRowDelegate *delegate = new ProductRowDelegate(widget);
+
+    QTableView *table = new QTableView(widget);
+    table->setModel(productModel);
+    table->setItemDelegate(delegate);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->setEditTriggers(QAbstractItemView::AllEditTriggers);
+    table->verticalHeader()->hide();
+    // Fixed row heights and section sizes keep layout independent of the row count
+    table->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    table->verticalHeader()->setDefaultSectionSize(thumbnails.size().height() + 4);
+    table->setIconSize(thumbnails.size());
+    table->horizontalHeader()->setSectionResizeMode(ProductTableModel::NameColumn, QHeaderView::Stretch);
+    layout->addWidget(table);
+
+    connect(delegate, &ProductRowDelegate::addToCartClicked, this, [this](int row) {
+        Product cartProduct = productModel->nodeAt(row)->product;
+        cartProduct.quantity = productModel->addQuantity(row);
+        addToCart(cartProduct);
+        QMessageBox::information(this, "Add to Cart", "Product added to cart successfully!");
+    });
+
+    QPushButton *backButton = new QPushButton("Back", widget);
+    backButton->setProperty("role", "primary");
+
+    connect(backButton, &QPushButton::clicked, pages, &PageManager::back);
+
+    layout->addWidget(backButton);
+
+    widget->setLayout(layout);
+    return widget;
+}
+
+void MainWindow::searchProducts() {
+    pages->show(PageManager::ProductsPage);
+    searchPanel->focusName();
+}
+
+// Applies the search panel's query to the table, changing only the rows that
+// differ from what it shows
+void MainWindow::runSearch() {
+    TRACE_SPAN("MainWindow::runSearch");
+    productModel->updateNodes(catalogSearch.run(searchPanel->query()));
+    searchPanel->setResultCount(productModel->rowCount());
+}
+
+void MainWindow::editProductQuantity() {
+    bool ok;
+    int code = QInputDialog::getInt(this, tr("Edit Product Quantity"), tr("Product Code:"), 0, 0, 10000, 1, &ok);
+    if (!ok) return;
+
+    Product* product = products.findProduct(code);
+    if (product) {
+        int quantity = QInputDialog::getInt(this, tr("Edit Product Quantity"), tr("New Quantity:"), product->quantity, 0, 10000, 1, &ok);
+        if (!ok) return;
+
+        product->quantity = quantity;
+        catalogLog.recordQuantity(code, quantity);
+        compactCatalogIfNeeded();
+
+        QMessageBox::information(this, tr("Edit Product Quantity"), tr("Product quantity updated successfully!"));
+    } else {
+        QMessageBox::warning(this, tr("Edit Product Quantity"), tr("Product not found!"));
+    }
+}
+
+void MainWindow::deleteProduct() {
+    bool ok;
+    int code = QInputDialog::getInt(this, tr("Delete Product"), tr("Product Code:"), 0, 0, 10000, 1, &ok);
+    if (!ok) return;
+
+    Product* product = products.findProduct(code);
+    if (product) {
+        products.removeProduct(code);
+        if (productModel) {
+            productModel->setNodes({}); // its node pointers may include the removed product
+        }
+        catalogLog.recordDelete(code);
+        compactCatalogIfNeeded();
+        QMessageBox::information(this, tr("Delete Product"), tr("Product deleted successfully!"));
+    } else {
+        QMessageBox::warning(this, tr("Delete Product"), tr("Product not found!"));
+    }
+}
+void MainWindow::viewOrders() {
+    loadOrderHistory();
+    pages->show(PageManager::OrdersPage);
+}
+
+// One page of orders at a time; an order's line items are only formatted
+// when it is selected
+QWidget* MainWindow::buildOrdersPage() {
+    QWidget *viewOrdersWidget = new QWidget;
+    orderModel = new OrderHistoryModel(orders, 100, viewOrdersWidget);
+
+    QTableView *table = new QTableView(viewOrdersWidget);
+    table->setModel(orderModel);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->setSelectionMode(QAbstractItemView::SingleSelection);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->verticalHeader()->hide();
+    table->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    table->horizontalHeader()->setSectionResizeMode(OrderHistoryModel::CustomerColumn, QHeaderView::Stretch);
+
+    orderDetails = new QTextEdit(viewOrdersWidget);
+    orderDetails->setReadOnly(true);
+    orderDetails->setProperty("role", "details");
+
+    QPushButton *previousButton = new QPushButton("Previous", viewOrdersWidget);
+    QPushButton *nextButton = new QPushButton("Next", viewOrdersWidget);
+    QLabel *pageLabel = new QLabel(viewOrdersWidget);
+    QSpinBox *orderNumber = new QSpinBox(viewOrdersWidget);
+    orderNumber->setPrefix("Order #");
+    QPushButton *goToOrderButton = new QPushButton("Go", viewOrdersWidget);
+    QDateEdit *orderDate = new QDateEdit(QDate::currentDate(), viewOrdersWidget);
+    orderDate->setCalendarPopup(true);
+    QPushButton *goToDateButton = new QPushButton("Go", viewOrdersWidget);
+
+    QHBoxLayout *navigation = new QHBoxLayout;
+    navigation->addWidget(previousButton);
+    navigation->addWidget(pageLabel);
+    navigation->addWidget(nextButton);
+    navigation->addStretch();
+    navigation->addWidget(orderNumber);
+    navigation->addWidget(goToOrderButton);
+    navigation->addWidget(orderDate);
+    navigation->addWidget(goToDateButton);
+
+    auto selectOrder = [this, table](int orderIndex) {
+        if (orderModel->orderCount() == 0) return;
+        int row = orderModel->showOrder(orderIndex);
+        table->selectRow(row);
+        table->scrollTo(orderModel->index(row, 0));
+    };
+
+    connect(orderModel, &OrderHistoryModel::pageChanged, viewOrdersWidget, [=](int page, int pageCount) {
+        pageLabel->setText(QString("Page %1 of %2").arg(page + 1).arg(pageCount));
+        previousButton->setEnabled(page > 0);
+        nextButton->setEnabled(page + 1 < pageCount);
+        orderNumber->setRange(1, max(1, orderModel->orderCount()));
+        orderDetails->clear();
+    });
+    connect(previousButton, &QPushButton::clicked, orderModel, [this]() { orderModel->setPage(orderModel->page() - 1); });
+    connect(nextButton, &QPushButton::clicked, orderModel, [this]() { orderModel->setPage(orderModel->page() + 1); });
+    connect(goToOrderButton, &QPushButton::clicked, viewOrdersWidget, [=]() { selectOrder(orderNumber->value() - 1); });
+    connect(goToDateButton, &QPushButton::clicked, viewOrdersWidget, [=]() {
+        int orderIndex = orderModel->firstOrderOn(orderDate->date());
+        if (orderIndex >= orderModel->orderCount()) {
+            QMessageBox::information(this, tr("View Orders"), tr("No orders on or after that date."));
+            return;
+        }
+        selectOrder(orderIndex);
+    });
+    connect(table->selectionModel(), &QItemSelectionModel::currentRowChanged, viewOrdersWidget, [this](const QModelIndex& current) {
+        if (!current.isValid()) {
+            orderDetails->clear();
+            return;
+        }
+        orderDetails->setText(OrderHistoryModel::describe(orderModel->orderAt(current.row())));
+    });
+
+    QPushButton *backButton = new QPushButton("Back", viewOrdersWidget);
+    backButton->setProperty("role", "primary");
+    connect(backButton, &QPushButton::clicked, pages, &PageManager::back);
+
+    QVBoxLayout *layout = new QVBoxLayout;
+    layout->addLayout(navigation);
+    layout->addWidget(table, 3);
+    layout->addWidget(orderDetails, 2);
+    layout->addWidget(backButton);
+    viewOrdersWidget->setLayout(layout);
+    return viewOrdersWidget;
+}
+
+void MainWindow::refreshOrders() {
+    orderModel->reload();
+}
+
+void MainWindow::viewCart() {
+    pages->show(PageManager::CartPage);
+}
+
+QWidget* MainWindow::buildCartPage() {
+    QWidget *cartWidget = new QWidget;
+    cartText = new QTextEdit(cartWidget);
+    cartText->setReadOnly(true);
+    cartText->setProperty("role", "details");
+
+    QPushButton *backButton = new QPushButton("Back", cartWidget);
+    backButton->setProperty("role", "primary");
+    connect(backButton, &QPushButton::clicked, pages, &PageManager::back);
+
+    QPushButton *checkoutButton = new QPushButton("Checkout", cartWidget);
+    checkoutButton->setProperty("role", "primary");
+    connect(checkoutButton, &QPushButton::clicked, this, &MainWindow::checkout);
+
+    QVBoxLayout *layout = new QVBoxLayout;
+    layout->addWidget(cartText);
+    layout->addWidget(checkoutButton);
+    layout->addWidget(backButton);
+    cartWidget->setLayout(layout);
+    return cartWidget;
+}
+
+void MainWindow::refreshCart() {
+    QString cartDetails;
+
+    stack<Product> tempCart = cart;
+    while (!tempCart.empty()) {
+        Product product = tempCart.top();
+        tempCart.pop();
+
+        cartDetails += QString("Code: %1\nName: %2\nCategory: %3\nSubCategory: %4\nSkin Type: %5\nRange: %6\nPrice: %7\nQuantity: %8\n\n")
+                           .arg(product.code)
+                           .arg(QString::fromStdString(product.name))
+                           .arg(QString::fromStdString(product.categoryName()))
+                           .arg(QString::fromStdString(product.subCategoryName()))
+                           .arg(QString::fromStdString(product.skinTypeName()))
+                           .arg(QString::fromStdString(product.rangeName()))
+                           .arg(product.price)
+                           .arg(product.quantity);
+    }
+
+    cartText->setText(cartDetails);
+}
+
+void MainWindow::checkout() {
+    SCOPED_LATENCY("MainWindow::checkout");
+    if (currentUser.username.empty()) {
+        QMessageBox::information(this, tr("Checkout"), tr("Please log in or register to proceed with checkout."));
+        showLoginScreen();
+        return;
+    }
+
+    double total = 0.0;
+    stack<Product> tempCart = cart;
+
+    while (!tempCart.empty()) {
+        const Product& product = tempCart.top();
+        total += product.price * product.quantity;
+        tempCart.pop();
+    }
+
+    bool ok;
+    QString customerName = QInputDialog::getText(this, tr("Checkout"), tr("Name:"), QLineEdit::Normal, "", &ok);
+    if (!ok || customerName.isEmpty()) return;
+
+    QString address = QInputDialog::getText(this, tr("Checkout"), tr("Address:"), QLineEdit::Normal, "", &ok);
+    if (!ok || address.isEmpty()) return;
+
+    QString contact = QInputDialog::getText(this, tr("Checkout"), tr("Contact:"), QLineEdit::Normal, "", &ok);
+    if (!ok || contact.isEmpty()) return;
+
+    QString email = QInputDialog::getText(this, tr("Checkout"), tr("Email:"), QLineEdit::Normal, "", &ok);
+    if (!ok || email.isEmpty()) return;
+
+    vector<Product> productsInCart;
+    tempCart = cart;
+    while (!tempCart.empty()) {
+        productsInCart.push_back(tempCart.top());
+        tempCart.pop();
+    }
+
+    Order order(customerName.toStdString(), address.toStdString(), contact.toStdString(), email.toStdString(), productsInCart);
+    order.placedAt = QDateTime::currentSecsSinceEpoch();
+    saveOrderToFile(order);
+    // Until the history is opened the order only needs to reach the log
+    if (ordersLoading) {
+        ordersPlacedWhileLoading.push_back(order);
+    } else if (isLoaded(Orders)) {
+        orders.enqueue(order);
+    }
+
+    cart = stack<Product>();
+    QMessageBox::information(this, tr("Checkout"), tr("Order placed successfully! Total: %1").arg(total));
+    showCustomerMenu();
+}
+
+void MainWindow::showStaffMenu() {
+    pages->show(PageManager::StaffMenuPage);
+}
+
+QWidget* MainWindow::buildStaffMenu() {
+    QLabel *staffMenuLabel = new QLabel("Staff Menu");
+    staffMenuLabel->setProperty("role", "title");
+    staffMenuLabel->setAlignment(Qt::AlignCenter);
+
+    QPushButton *addProductButton = new QPushButton("Add Product");
+    QPushButton *editProductQuantityButton = new QPushButton("Edit Product Quantity");
+    QPushButton *deleteProductButton = new QPushButton("Delete Product");
+    QPushButton *displayProductsButton = new QPushButton("Display Products");
+    QPushButton *searchProductsButton = new QPushButton("Search Products");
+    QPushButton *viewOrdersButton = new QPushButton("View Orders");
+    QPushButton *diagnosticsButton = new QPushButton("Diagnostics");
+    QPushButton *traceButton = new QPushButton(Trace::enabled() ? "Stop Trace" : "Start Trace");
+    QPushButton *logoutButton = new QPushButton("Logout");
+
+    addProductButton->setProperty("role", "primary");
+    editProductQuantityButton->setProperty("role", "primary");
+    deleteProductButton->setProperty("role", "primary");
+    displayProductsButton->setProperty("role", "primary");
+    searchProductsButton->setProperty("role", "primary");
+    viewOrdersButton->setProperty("role", "primary");
+    diagnosticsButton->setProperty("role", "primary");
+    traceButton->setProperty("role", "primary");
+    logoutButton->setProperty("role", "primary");
+    enableWhenLoaded(addProductButton, Products);
+    enableWhenLoaded(editProductQuantityButton, Products);
+    enableWhenLoaded(deleteProductButton, Products);
+    enableWhenLoaded(displayProductsButton, Products);
+    enableWhenLoaded(searchProductsButton, Products);
+
+    connect(addProductButton, &QPushButton::clicked, this, &MainWindow::on_addProductButton_clicked);
+    connect(editProductQuantityButton, &QPushButton::clicked, this, &MainWindow::on_editProductQuantityButton_clicked);
+    connect(deleteProductButton, &QPushButton::clicked, this, &MainWindow::on_deleteProductButton_clicked);
+    connect(displayProductsButton, &QPushButton::clicked, this, &MainWindow::on_displayProductsButton_clicked);
+    connect(searchProductsButton, &QPushButton::clicked, this, &MainWindow::on_searchProductsButton_clicked);
+    connect(viewOrdersButton, &QPushButton::clicked, this, &MainWindow::on_viewOrdersButton_clicked);
+    connect(diagnosticsButton, &QPushButton::clicked, this, [this]() { pages->show(PageManager::DiagnosticsPage); });
+    connect(traceButton, &QPushButton::clicked, this, [this, traceButton]() { toggleTrace(traceButton); });
+    connect(logoutButton, &QPushButton::clicked, this, &MainWindow::on_logoutButton_clicked);
+
+    QVBoxLayout *layout = new QVBoxLayout;
+    layout->addWidget(staffMenuLabel);
+    layout->addWidget(addProductButton);
+    layout->addWidget(editProductQuantityButton);
+    layout->addWidget(deleteProductButton);
+    layout->addWidget(displayProductsButton);
+    layout->addWidget(searchProductsButton);
+    layout->addWidget(viewOrdersButton);
+    layout->addWidget(diagnosticsButton);
+    layout->addWidget(traceButton);
+    layout->addWidget(logoutButton);
+
+    QWidget *staffWidget = new QWidget;
+    staffWidget->setLayout(layout);
+    return staffWidget;
+}
+
+// Starts a trace, or stops it and saves what was recorded
+void MainWindow::toggleTrace(QPushButton* button) {
+    if (!Trace::enabled()) {
+        Trace::start();
+        button->setText("Stop Trace");
+        statusBar()->showMessage(tr("Tracing started"), 3000);
+        return;
+    }
+    Trace::stop();
+    button->setText("Start Trace");
+    QString path = QFileDialog::getSaveFileName(this, tr("Save Trace"), "trace.json", tr("Chrome trace files (*.json)"));
+    if (path.isEmpty()) return;
+    if (Trace::writeChromeJson(QFile::encodeName(path).toStdString())) {
+        statusBar()->showMessage(tr("Trace saved to %1").arg(path), 5000);
+    } else {
+        QMessageBox::warning(this, tr("Save Trace"), tr("Unable to write %1.").arg(path));
+    }
+}
+
+// Latency histograms and the memory held by each store; the memory figures
+// walk every structure, so they are only gathered when the page is shown
+QWidget* MainWindow::buildDiagnosticsPage() {
+    QWidget *widget = new QWidget;
+    diagnostics = new DiagnosticsPage([this]() {
+        size_t cartBytes = cart.size() * sizeof(Product);
+        return vector<MemoryUsage>{
+            {tr("Users"), users.size(), users.memoryUsed()},
+            {tr("Products (tree and index)"), products.size(), products.memoryUsed()},
+            {tr("Orders"), orders.size(), orders.memoryUsed()},
+            {tr("Cart"), cart.size(), cartBytes},
+            {tr("Search results"), 0, catalogSearch.memoryUsed()},
+            {tr("Thumbnails"), 0, thumbnails.memoryUsed()},
+        };
+    }, widget);
+
+    QPushButton *backButton = new QPushButton("Back", widget);
+    backButton->setProperty("role", "primary");
+    connect(backButton, &QPushButton::clicked, pages, &PageManager::back);
+
+    QVBoxLayout *layout = new QVBoxLayout(widget);
+    layout->addWidget(diagnostics);
+    layout->addWidget(backButton);
+    return widget;
+}
+
+void MainWindow::showCustomerMenu() {
+    pages->show(PageManager::CustomerMenuPage);
+}
+
+QWidget* MainWindow::buildCustomerMenu() {
+    QLabel *customerMenuLabel = new QLabel("Customer Menu");
+    customerMenuLabel->setProperty("role", "title");
+    customerMenuLabel->setAlignment(Qt::AlignCenter);
+
+    QPushButton *displayProductsButton = new QPushButton("Display Products");
+    QPushButton *searchProductsButton = new QPushButton("Search Products");
+    QPushButton *viewCartButton = new QPushButton("View Cart");
+    QPushButton *identifySkinTypeButton = new QPushButton("Identify Skin Type");
+    QPushButton *logoutButton = new QPushButton("Logout");
+
+    displayProductsButton->setProperty("role", "primary");
+    searchProductsButton->setProperty("role", "primary");
+    viewCartButton->setProperty("role", "primary");
+    identifySkinTypeButton->setProperty("role", "primary");
+    logoutButton->setProperty("role", "primary");
+    enableWhenLoaded(displayProductsButton, Products);
+    enableWhenLoaded(searchProductsButton, Products);
+
+    connect(displayProductsButton, &QPushButton::clicked, this, &MainWindow::on_displayProductsButton_clicked);
+    connect(searchProductsButton, &QPushButton::clicked, this, &MainWindow::on_searchProductsButton_clicked);
+    connect(viewCartButton, &QPushButton::clicked, this, &MainWindow::on_viewCartButton_clicked);
+    connect(identifySkinTypeButton, &QPushButton::clicked, this, &MainWindow::on_identifySkinTypeButton_clicked);
+    connect(logoutButton, &QPushButton::clicked, this, &MainWindow::on_logoutButton_clicked);
+
+    QVBoxLayout *layout = new QVBoxLayout;
+    layout->addWidget(customerMenuLabel);
+    layout->addWidget(displayProductsButton);
+    layout->addWidget(searchProductsButton);
+    layout->addWidget(viewCartButton);
+    layout->addWidget(identifySkinTypeButton);
+    layout->addWidget(logoutButton);
+
+    QWidget *customerWidget = new QWidget;
+    customerWidget->setLayout(layout);
+    return customerWidget;
+}
+
+void MainWindow::addToCartFromDisplay() {
+    bool ok;
+    int code = QInputDialog::getInt(this, tr("Add to Cart"), tr("Enter Product Code:"), 0, 0, 10000, 1, &ok);
+    if (!ok) return;
+
+    Product* product = products.findProduct(code);
+    if (product) {
+        int quantity = QInputDialog::getInt(this, tr("Add to Cart"), tr("Enter Quantity:"), 1, 1, product->quantity, 1, &ok);
+        if (!ok) return;
+
+        Product cartProduct = *product;
+        cartProduct.quantity = quantity;
+        cart.push(cartProduct);
+
+        QMessageBox::information(this, tr("Add to Cart"), tr("Product added to cart successfully!"));
+    } else {
+        QMessageBox::warning(this, tr("Add to Cart"), tr("Product not found!"));
+    }
+}
+
+void MainWindow::editProductFromDisplay() {
+    bool ok;
+    int code = QInputDialog::getInt(this, tr("Edit Product"), tr("Enter Product Code:"), 0, 0, 10000, 1, &ok);
+    if (!ok) return;
+
+    Product* product = products.findProduct(code);
+    if (product) {
+        QString name = QInputDialog::getText(this, tr("Edit Product"), tr("Product Name:"), QLineEdit::Normal, QString::fromStdString(product->name), &ok);
+        if (!ok || name.isEmpty()) return;
+
+        QString category = QInputDialog::getItem(this, tr("Edit Product"), tr("Category:"), toStringList(Taxonomy::instance().categoryNames()), 0, false, &ok);
+        if (!ok || category.isEmpty()) return;
+
+        QStringList subCategories = toStringList(Taxonomy::instance().subCategoryNames(category.toStdString()));
+
+        QString subCategory = QInputDialog::getItem(this, tr("Edit Product"), tr("SubCategory:"), subCategories, 0, false, &ok);
+        if (!ok || subCategory.isEmpty()) return;
+
+        QString skinType = QInputDialog::getItem(this, tr("Edit Product"), tr("Skin Type:"), toStringList(Taxonomy::instance().skinTypeNames()), 0, false, &ok);
+        if (!ok || skinType.isEmpty()) return;
+
+        QString range = QInputDialog::getItem(this, tr("Edit Product"), tr("Price Range:"), toStringList(Taxonomy::instance().rangeNames()), 0, false, &ok);
+        if (!ok || range.isEmpty()) return;
+
+        double price = QInputDialog::getDouble(this, tr("Edit Product"), tr("Price:"), product->price, 0, 10000, 2, &ok);
+        if (!ok) return;
+
+        int quantity = QInputDialog::getInt(this, tr("Edit Product"), tr("Quantity:"), product->quantity, 0, 1000, 1, &ok);
+        if (!ok) return;
+
+        QString imagePath = QInputDialog::getText(this, tr("Edit Product"), tr("Image Path (optional):"), QLineEdit::Normal, QString::fromStdString(product->imagePath), &ok);
+        if (!ok) return;
+
+        Product edited(code, name.toStdString(), category.toStdString(), subCategory.toStdString(), skinType.toStdString(), range.toStdString(), price, quantity);
+        edited.imagePath = imagePath.trimmed().toStdString();
+        products.updateProduct(edited);
+        catalogLog.recordEdit(edited);
+        compactCatalogIfNeeded();
+
+        QMessageBox::information(this, tr("Edit Product"), tr("Product edited successfully!"));
+    } else {
+        QMessageBox::warning(this, tr("Edit Product"), tr("Product not found!"));
+    }
+}
+
+void MainWindow::showLoginScreen() {
+    pages->show(PageManager::LoginPage);
+}
+
+QWidget* MainWindow::buildLoginScreen() {
+    QPushButton *registerButton = new QPushButton("Register");
+    QPushButton *loginButton = new QPushButton("Login");
+    enableWhenLoaded(registerButton, Users);
+    enableWhenLoaded(loginButton, Users);
+    connect(registerButton, &QPushButton::clicked, this, &MainWindow::on_registerButton_clicked);
+    connect(loginButton, &QPushButton::clicked, this, &MainWindow::on_loginButton_clicked);
+
+    QVBoxLayout *layout = new QVBoxLayout;
+    layout->addWidget(registerButton);
+    layout->addWidget(loginButton);
+    QWidget *loginWidget = new QWidget;
+    loginWidget->setLayout(layout);
+    return loginWidget;
+}
+void MainWindow::showMainPage() {
+    pages->show(PageManager::MainPage);
+}
+
+QWidget* MainWindow::buildMainPage() {
+    // Set the main layout
+    QVBoxLayout *mainLayout = new QVBoxLayout;
+
+    QWidget *centralWidget = new QWidget;
+
+    QLabel *welcomeLabel = new QLabel("   WELCOME TO COSMOCONTROL");
+    welcomeLabel->setObjectName("welcomeLabel");
+    welcomeLabel->setAlignment(Qt::AlignCenter);
+
+    QPushButton *registerButton = new QPushButton("Register");
+    QPushButton *loginButton = new QPushButton("Login");
+    registerButton->setProperty("role", "header");
+    loginButton->setProperty("role", "header");
+    enableWhenLoaded(registerButton, Users);
+    enableWhenLoaded(loginButton, Users);
+    connect(registerButton, &QPushButton::clicked, this, &MainWindow::on_registerButton_clicked);
+    connect(loginButton, &QPushButton::clicked, this, &MainWindow::on_loginButton_clicked);
+
+    QHBoxLayout *headerLayout = new QHBoxLayout;
+    headerLayout->addStretch();
+    headerLayout->addWidget(welcomeLabel);
+    headerLayout->addStretch();
+    headerLayout->addWidget(registerButton);
+    headerLayout->addWidget(loginButton);
+    headerLayout->setAlignment(Qt::AlignTop);
+
+    mainLayout->addLayout(headerLayout);
+
+    // Add the buttons in a horizontal layout
+    QHBoxLayout *buttonLayout = new QHBoxLayout;
+
+    QPushButton *displayProductsButton = new QPushButton("Display Products");
+    QPushButton *searchProductsButton = new QPushButton("Search Products");
+    QPushButton *viewCartButton = new QPushButton("View Cart");
+    QPushButton *identifySkinTypeButton = new QPushButton("Identify Skin Type");
+
+    displayProductsButton->setProperty("role", "tile");
+    searchProductsButton->setProperty("role", "tile");
+    enableWhenLoaded(displayProductsButton, Products);
+    enableWhenLoaded(searchProductsButton, Products);
+    viewCartButton->setProperty("role", "tile");
+    identifySkinTypeButton->setProperty("role", "tile");
+
+    connect(displayProductsButton, &QPushButton::clicked, this, &MainWindow::on_displayProductsButton_clicked);
+    connect(searchProductsButton, &QPushButton::clicked, this, &MainWindow::on_searchProductsButton_clicked);
+    connect(viewCartButton, &QPushButton::clicked, this, &MainWindow::on_viewCartButton_clicked);
+    connect(identifySkinTypeButton, &QPushButton::clicked, this, &MainWindow::on_identifySkinTypeButton_clicked);
+
+    buttonLayout->addWidget(displayProductsButton);
+    buttonLayout->addWidget(searchProductsButton);
+    buttonLayout->addWidget(viewCartButton);
+    buttonLayout->addWidget(identifySkinTypeButton);
+    buttonLayout->setAlignment(Qt::AlignJustify);
+
+    mainLayout->addLayout(buttonLayout);
+
+    // Add the image, decoded in the background
+    QLabel *imageLabel = new QLabel;
+    imageLabel->setAlignment(Qt::AlignCenter);
+    images.loadInto(imageLabel, "Main image.jpeg", QSize(800, 600));
+    mainLayout->addWidget(imageLabel);
+
+    centralWidget->setLayout(mainLayout);
+    return centralWidget;
+}
+
+void MainWindow::addToCart(const Product& product) {
+    cart.push(product);
+}
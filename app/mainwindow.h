@@ -0,0 +1,122 @@
+#ifndef MAINWINDOW_H
+#define MAINWINDOW_H
+
+#include <QMainWindow>
+#include <QTextEdit>
+#include <QThreadPool>
+#include <stack>
+#include <vector>
+#include "models.h"
+#include "catalog_log.h"
+#include "persistence_service.h"
+#include "page_manager.h"
+#include "image_service.h"
+#include "thumbnail_cache.h"
+#include "catalog_search.h"
+
+using namespace std;
+
+class ProductTableModel;
+class OrderHistoryModel;
+class SearchPanel;
+class DiagnosticsPage;
+class OrderLogReader;
+class QPushButton;
+
+// MainWindow class definition
+class MainWindow : public QMainWindow {
+    Q_OBJECT
+
+public:
+    // Stores loaded after the window is shown
+    enum Store { Users = 1, Products = 2, Orders = 4 };
+
+    MainWindow(QWidget *parent = nullptr);
+    ~MainWindow();
+    void addToCart(const Product& product);
+    bool isLoaded(Store store) const { return loadedStores & store; }
+
+signals:
+    void storeLoaded(MainWindow::Store store);
+
+private slots:
+    void on_registerButton_clicked();
+    void on_loginButton_clicked();
+    void on_addProductButton_clicked();
+    void on_editProductQuantityButton_clicked();
+    void on_deleteProductButton_clicked();
+    void on_displayProductsButton_clicked();
+    void on_searchProductsButton_clicked();
+    void on_viewOrdersButton_clicked();
+    void on_viewCartButton_clicked();
+    void on_identifySkinTypeButton_clicked();
+    void on_logoutButton_clicked();
+    void addToCartFromDisplay();
+    void editProductFromDisplay();
+    void onCatalogSaved(bool ok);
+    void onWriteFailed(const QString& path);
+
+
+private:
+    UserList users;
+    ProductBST products;
+    CatalogSearch catalogSearch;
+    PersistenceService persistence; // declared before catalogLog, which writes through it
+    CatalogLog catalogLog;
+    OrderQueue orders; // empty until the order history is first opened
+    vector<Order> ordersPlacedWhileLoading; // already in the log, past where the loader stops
+    stack<Product> cart;
+    User currentUser;
+    bool isCurrentUserStaff;
+    PageManager* pages;
+    ImageService images;
+    ThumbnailCache thumbnails;
+    // Widgets of the persistent pages whose data is refreshed
+    ProductTableModel* productModel;
+    SearchPanel* searchPanel;
+    QTextEdit* cartText;
+    OrderHistoryModel* orderModel;
+    QTextEdit* orderDetails;
+    DiagnosticsPage* diagnostics;
+    QThreadPool loaders;
+    int loadedStores;
+    bool ordersLoading;
+
+    void saveUserToFile(const User& user);
+    void loadUsersFromFile(UserList& loaded);
+    void saveProductsToFile();
+    void loadProductsFromFile(ProductBST& loaded);
+    void compactCatalogIfNeeded();
+    void saveOrderToFile(const Order& order);
+    void loadOrdersFromFile(OrderLogReader& reader, OrderQueue& loaded);
+    void startLoading();
+    void loadOrderHistory();
+    void finishLoading(Store store);
+    void enableWhenLoaded(QPushButton* button, Store store);
+    void displayProducts(bool isStaff);
+    void searchProducts();
+    void runSearch();
+    void editProductQuantity();
+    void deleteProduct();
+    void viewOrders();
+    void viewCart();
+    void checkout();
+    void showMainPage();
+    void showStaffMenu();
+    void showCustomerMenu();
+    void showLoginScreen();
+    void toggleTrace(QPushButton* button);
+    QWidget* buildMainPage();
+    QWidget* buildLoginScreen();
+    QWidget* buildStaffMenu();
+    QWidget* buildCustomerMenu();
+    QWidget* buildProductsPage();
+    QWidget* buildCartPage();
+    QWidget* buildOrdersPage();
+    QWidget* buildDiagnosticsPage();
+    void refreshCart();
+    void refreshOrders();
+
+};
+
+#endif // MAINWINDOW_H
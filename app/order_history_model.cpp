@@ -0,0 +1,135 @@
+#include "order_history_model.h"
+#include "models.h"
+#include "trace.h"
+#include <QDateTime>
+#include <algorithm>
+
+OrderHistoryModel::OrderHistoryModel(const OrderQueue& orders, int pageSize, QObject* parent)
+    : QAbstractTableModel(parent), orders(orders), pageSize(max(1, pageSize)), currentPage(0) {}
+
+void OrderHistoryModel::reload() {
+    TRACE_SPAN("OrderHistoryModel::reload");
+    beginResetModel();
+    currentPage = min(currentPage, pageCount() - 1);
+    endResetModel();
+    emit pageChanged(currentPage, pageCount());
+}
+
+int OrderHistoryModel::orderCount() const {
+    return static_cast<int>(orders.size());
+}
+
+int OrderHistoryModel::pageCount() const {
+    return max(1, (orderCount() + pageSize - 1) / pageSize);
+}
+
+void OrderHistoryModel::setPage(int page) {
+    page = max(0, min(page, pageCount() - 1));
+    if (page == currentPage) return;
+    beginResetModel();
+    currentPage = page;
+    endResetModel();
+    emit pageChanged(currentPage, pageCount());
+}
+
+int OrderHistoryModel::showOrder(int orderIndex) {
+    orderIndex = max(0, min(orderIndex, orderCount() - 1));
+    setPage(orderIndex / pageSize);
+    return orderIndex - firstRow();
+}
+
+int OrderHistoryModel::firstOrderOn(const QDate& date) const {
+    long long start = QDateTime(date, QTime(0, 0)).toSecsSinceEpoch();
+    int low = 0;
+    int high = orderCount();
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (orders.at(mid).placedAt < start) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+const Order& OrderHistoryModel::orderAt(int row) const {
+    return orders.at(firstRow() + row);
+}
+
+QString OrderHistoryModel::describe(const Order& order) {
+    QString text = QString("Customer Name: %1\nAddress: %2\nContact: %3\nEmail: %4\n\nProducts:\n")
+                       .arg(QString::fromStdString(order.customerName),
+                            QString::fromStdString(order.address),
+                            QString::fromStdString(order.contact),
+                            QString::fromStdString(order.email));
+    for (const auto& product : order.products) {
+        text += QString("    Code: %1\n    Name: %2\n    Category: %3\n    SubCategory: %4\n    Skin Type: %5\n    Range: %6\n    Price: %7\n    Quantity: %8\n\n")
+                    .arg(QString::number(product.code),
+                         QString::fromStdString(product.name),
+                         QString::fromStdString(product.categoryName()),
+                         QString::fromStdString(product.subCategoryName()),
+                         QString::fromStdString(product.skinTypeName()),
+                         QString::fromStdString(product.rangeName()),
+                         QString::number(product.price),
+                         QString::number(product.quantity));
+    }
+    return text;
+}
+
+int OrderHistoryModel::rowCount(const QModelIndex& parent) const {
+    if (parent.isValid()) return 0;
+    return max(0, min(pageSize, orderCount() - firstRow()));
+}
+
+int OrderHistoryModel::columnCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant OrderHistoryModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= rowCount()) return QVariant();
+    if (role != Qt::DisplayRole) return QVariant();
+    const Order& order = orderAt(index.row());
+    switch (index.column()) {
+    case NumberColumn:
+        return firstRow() + index.row() + 1;
+    case DateColumn:
+        if (order.placedAt == 0) return QString();
+        return QDateTime::fromSecsSinceEpoch(order.placedAt).toString(QStringLiteral("yyyy-MM-dd hh:mm"));
+    case CustomerColumn:
+        return QString::fromStdString(order.customerName);
+    case EmailColumn:
+        return QString::fromStdString(order.email);
+    case ItemsColumn:
+        return static_cast<int>(order.products.size());
+    case TotalColumn: {
+        double total = 0.0;
+        for (const auto& product : order.products) {
+            total += product.price * product.quantity;
+        }
+        return QString::number(total, 'f', 2);
+    }
+    }
+    return QVariant();
+}
+
+QVariant OrderHistoryModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+    switch (section) {
+    case NumberColumn:
+        return tr("Order");
+    case DateColumn:
+        return tr("Date");
+    case CustomerColumn:
+        return tr("Customer");
+    case EmailColumn:
+        return tr("Email");
+    case ItemsColumn:
+        return tr("Items");
+    case TotalColumn:
+        return tr("Total");
+    }
+    return QVariant();
+}
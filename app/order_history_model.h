@@ -0,0 +1,54 @@
+#ifndef ORDER_HISTORY_MODEL_H
+#define ORDER_HISTORY_MODEL_H
+
+#include <QAbstractTableModel>
+#include <QDate>
+
+class Order;
+class OrderQueue;
+
+// One page of the order history as a table, one row per order. Rows read
+// straight from the OrderQueue and are formatted only when the view paints
+// them; a single order's line items are formatted by describe() when it is
+// selected. Orders are stored oldest first, which is also date order, so
+// jumping to a date is a binary search.
+class OrderHistoryModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    enum Column { NumberColumn, DateColumn, CustomerColumn, EmailColumn, ItemsColumn, TotalColumn, ColumnCount };
+
+    explicit OrderHistoryModel(const OrderQueue& orders, int pageSize = 100, QObject* parent = nullptr);
+
+    // Picks up orders placed since the last call, keeping the current page
+    void reload();
+    int page() const { return currentPage; }
+    int pageCount() const;
+    void setPage(int page);
+    // Shows the page holding the order and returns its row on that page
+    int showOrder(int orderIndex);
+    // Index of the first order placed on or after date; orders without a
+    // date come first. Returns the number of orders when there is none.
+    int firstOrderOn(const QDate& date) const;
+    int orderCount() const;
+    const Order& orderAt(int row) const;
+    // The order's customer details and line items as text
+    static QString describe(const Order& order);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+signals:
+    void pageChanged(int page, int pageCount);
+
+private:
+    const OrderQueue& orders;
+    int pageSize;
+    int currentPage;
+
+    int firstRow() const { return currentPage * pageSize; }
+};
+
+#endif // ORDER_HISTORY_MODEL_H
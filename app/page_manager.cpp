@@ -0,0 +1,30 @@
+#include "page_manager.h"
+#include <QStackedWidget>
+
+PageManager::PageManager(QStackedWidget* stack, QObject* parent) : QObject(parent), stack(stack), currentPage(MainPage) {}
+
+void PageManager::addPage(Page page, function<QWidget*()> build, function<void()> refresh) {
+    entries[page].build = move(build);
+    entries[page].refresh = move(refresh);
+}
+
+void PageManager::setHome(function<Page()> newHome) {
+    home = move(newHome);
+}
+
+void PageManager::show(Page page) {
+    Entry& entry = entries[page];
+    if (!entry.widget) {
+        entry.widget = entry.build();
+        stack->addWidget(entry.widget);
+    }
+    if (entry.refresh) {
+        entry.refresh();
+    }
+    stack->setCurrentWidget(entry.widget);
+    currentPage = page;
+}
+
+void PageManager::back() {
+    show(home ? home() : MainPage);
+}
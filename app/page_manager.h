@@ -0,0 +1,47 @@
+#ifndef PAGE_MANAGER_H
+#define PAGE_MANAGER_H
+
+#include <QObject>
+#include <functional>
+
+class QStackedWidget;
+class QWidget;
+
+using namespace std;
+
+// Keeps every screen of the main window alive in one QStackedWidget. A page
+// is built the first time it is shown; after that, showing it only runs its
+// refresh callback, so navigating never rebuilds a widget tree.
+class PageManager : public QObject {
+    Q_OBJECT
+
+public:
+    enum Page { MainPage, LoginPage, StaffMenuPage, CustomerMenuPage, ProductsPage, CartPage, OrdersPage, DiagnosticsPage, PageCount };
+
+    explicit PageManager(QStackedWidget* stack, QObject* parent = nullptr);
+
+    void addPage(Page page, function<QWidget*()> build, function<void()> refresh = nullptr);
+    // Decides, when back() is called, which page it returns to
+    void setHome(function<Page()> home);
+
+    void show(Page page);
+    Page current() const { return currentPage; }
+
+public slots:
+    // The action of every Back button
+    void back();
+
+private:
+    struct Entry {
+        function<QWidget*()> build;
+        function<void()> refresh;
+        QWidget* widget = nullptr;
+    };
+
+    QStackedWidget* stack;
+    Entry entries[PageCount];
+    function<Page()> home;
+    Page currentPage;
+};
+
+#endif // PAGE_MANAGER_H
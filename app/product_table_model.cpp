@@ -0,0 +1,244 @@
+#include "product_table_model.h"
+#include "models.h"
+#include "thumbnail_cache.h"
+#include "trace.h"
+#include <QApplication>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QSpinBox>
+#include <QStyleOption>
+#include <algorithm>
+
+using namespace std;
+
+// ProductTableModel implementation
+ProductTableModel::ProductTableModel(QObject* parent) : QAbstractTableModel(parent), thumbnails(nullptr) {}
+
+void ProductTableModel::setThumbnails(ThumbnailCache* cache) {
+    thumbnails = cache;
+    connect(thumbnails, &ThumbnailCache::thumbnailReady, this, [this]() {
+        // The view only repaints the rows it shows
+        if (!nodes.empty()) {
+            emit dataChanged(index(0, NameColumn), index(rowCount() - 1, NameColumn), {Qt::DecorationRole});
+        }
+    });
+}
+
+void ProductTableModel::setNodes(vector<ProductNode*> newNodes) {
+    beginResetModel();
+    nodes = move(newNodes);
+    addQuantities.assign(nodes.size(), 1);
+    endResetModel();
+}
+
+void ProductTableModel::updateNodes(vector<ProductNode*> newNodes) {
+    TRACE_SPAN("ProductTableModel::updateNodes");
+    // Rows whose node is in both lists stay put, so those nodes have to come
+    // in the same order in each. The rows between them become runs of removed
+    // and inserted rows, with each run's row counted after the runs before it
+    // have been applied. Slots tell which nodes a list holds.
+    uint32_t lastSlot = 0;
+    for (const ProductNode* node : nodes) lastSlot = max(lastSlot, node->slot);
+    for (const ProductNode* node : newNodes) lastSlot = max(lastSlot, node->slot);
+    vector<bool> inOld(size_t(lastSlot) + 1, false);
+    vector<bool> inNew(size_t(lastSlot) + 1, false);
+    for (const ProductNode* node : nodes) inOld[node->slot] = true;
+    for (const ProductNode* node : newNodes) inNew[node->slot] = true;
+
+    struct Run {
+        bool insert;
+        int row;
+        size_t first; // insertions only: position in newNodes
+        size_t length;
+    };
+    const size_t maxRuns = 64;
+    vector<Run> runs;
+    size_t i = 0;
+    size_t j = 0;
+    int row = 0;
+    while ((i < nodes.size() || j < newNodes.size()) && runs.size() <= maxRuns) {
+        if (i < nodes.size() && j < newNodes.size() && nodes[i] == newNodes[j]) {
+            ++i;
+            ++j;
+            ++row;
+        } else if (i < nodes.size() && !inNew[nodes[i]->slot]) {
+            size_t first = i;
+            while (i < nodes.size() && !inNew[nodes[i]->slot]) ++i;
+            runs.push_back({false, row, 0, i - first});
+        } else if (j < newNodes.size() && !inOld[newNodes[j]->slot]) {
+            size_t first = j;
+            while (j < newNodes.size() && !inOld[newNodes[j]->slot]) ++j;
+            runs.push_back({true, row, first, j - first});
+            row += static_cast<int>(j - first);
+        } else {
+            // Two nodes in both lists swapped places, e.g. their ranks changed
+            setNodes(move(newNodes));
+            return;
+        }
+    }
+    if (runs.size() > maxRuns) {
+        setNodes(move(newNodes));
+        return;
+    }
+
+    for (const Run& run : runs) {
+        int last = run.row + static_cast<int>(run.length) - 1;
+        if (run.insert) {
+            beginInsertRows(QModelIndex(), run.row, last);
+            nodes.insert(nodes.begin() + run.row, newNodes.begin() + run.first, newNodes.begin() + run.first + run.length);
+            addQuantities.insert(addQuantities.begin() + run.row, run.length, 1);
+            endInsertRows();
+        } else {
+            beginRemoveRows(QModelIndex(), run.row, last);
+            nodes.erase(nodes.begin() + run.row, nodes.begin() + last + 1);
+            addQuantities.erase(addQuantities.begin() + run.row, addQuantities.begin() + last + 1);
+            endRemoveRows();
+        }
+    }
+}
+
+int ProductTableModel::addQuantity(int row) const {
+    return max(1, min(addQuantities[row], nodes[row]->product.quantity));
+}
+
+int ProductTableModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : static_cast<int>(nodes.size());
+}
+
+int ProductTableModel::columnCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant ProductTableModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= rowCount()) return QVariant();
+    const Product& product = nodes[index.row()]->product;
+    if (role == Qt::DisplayRole || role == Qt::EditRole) {
+        switch (index.column()) {
+        case CodeColumn:
+            return product.code;
+        case NameColumn:
+            return QString::fromStdString(product.name);
+        case SkinTypeColumn:
+            return QString::fromStdString(product.skinTypeName());
+        case PriceColumn:
+            return role == Qt::EditRole ? QVariant(product.price) : QVariant(QString::number(product.price, 'f', 2));
+        case StockColumn:
+            return product.quantity;
+        case AddQuantityColumn:
+            return addQuantity(index.row());
+        case AddColumn:
+            return QStringLiteral("+");
+        }
+    } else if (role == Qt::DecorationRole && index.column() == NameColumn) {
+        if (thumbnails && !product.imagePath.empty()) {
+            QPixmap thumbnail = thumbnails->thumbnail(QString::fromStdString(product.imagePath));
+            if (!thumbnail.isNull()) return thumbnail;
+        }
+    } else if (role == Qt::TextAlignmentRole) {
+        if (index.column() == CodeColumn || index.column() == PriceColumn || index.column() == StockColumn || index.column() == AddQuantityColumn) {
+            return int(Qt::AlignRight | Qt::AlignVCenter);
+        }
+    }
+    return QVariant();
+}
+
+bool ProductTableModel::setData(const QModelIndex& index, const QVariant& value, int role) {
+    if (!index.isValid() || index.column() != AddQuantityColumn || role != Qt::EditRole) return false;
+    addQuantities[index.row()] = value.toInt();
+    emit dataChanged(index, index, {Qt::DisplayRole, Qt::EditRole});
+    return true;
+}
+
+QVariant ProductTableModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+    switch (section) {
+    case CodeColumn:
+        return tr("Code");
+    case NameColumn:
+        return tr("Name");
+    case SkinTypeColumn:
+        return tr("Skin Type");
+    case PriceColumn:
+        return tr("Price");
+    case StockColumn:
+        return tr("Quantity");
+    case AddQuantityColumn:
+        return tr("Add");
+    case AddColumn:
+        return QString();
+    }
+    return QVariant();
+}
+
+Qt::ItemFlags ProductTableModel::flags(const QModelIndex& index) const {
+    Qt::ItemFlags flags = QAbstractTableModel::flags(index);
+    if (index.isValid() && index.column() == AddQuantityColumn && nodes[index.row()]->product.quantity > 0) {
+        flags |= Qt::ItemIsEditable;
+    }
+    return flags;
+}
+
+// ProductRowDelegate implementation
+ProductRowDelegate::ProductRowDelegate(QObject* parent) : QStyledItemDelegate(parent) {}
+
+QWidget* ProductRowDelegate::createEditor(QWidget* parent, const QStyleOptionViewItem& option, const QModelIndex& index) const {
+    if (index.column() != ProductTableModel::AddQuantityColumn) {
+        return QStyledItemDelegate::createEditor(parent, option, index);
+    }
+    const ProductTableModel* model = qobject_cast<const ProductTableModel*>(index.model());
+    QSpinBox* spinBox = new QSpinBox(parent);
+    spinBox->setRange(1, max(1, model->nodeAt(index.row())->product.quantity));
+    spinBox->setFrame(false);
+    return spinBox;
+}
+
+void ProductRowDelegate::setEditorData(QWidget* editor, const QModelIndex& index) const {
+    if (QSpinBox* spinBox = qobject_cast<QSpinBox*>(editor)) {
+        spinBox->setValue(index.data(Qt::EditRole).toInt());
+        return;
+    }
+    QStyledItemDelegate::setEditorData(editor, index);
+}
+
+void ProductRowDelegate::setModelData(QWidget* editor, QAbstractItemModel* model, const QModelIndex& index) const {
+    if (QSpinBox* spinBox = qobject_cast<QSpinBox*>(editor)) {
+        spinBox->interpretText();
+        model->setData(index, spinBox->value(), Qt::EditRole);
+        return;
+    }
+    QStyledItemDelegate::setModelData(editor, model, index);
+}
+
+void ProductRowDelegate::paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const {
+    if (index.column() != ProductTableModel::AddColumn) {
+        QStyledItemDelegate::paint(painter, option, index);
+        return;
+    }
+    // A painted button, so the column needs no widgets
+    QStyleOptionButton button;
+    button.rect = option.rect.adjusted(2, 2, -2, -2);
+    button.text = index.data().toString();
+    button.state = option.state & QStyle::State_MouseOver;
+    button.state |= QStyle::State_Enabled;
+    const QWidget* widget = option.widget;
+    QStyle* style = widget ? widget->style() : QApplication::style();
+    style->drawControl(QStyle::CE_PushButton, &button, painter, widget);
+}
+
+bool ProductRowDelegate::editorEvent(QEvent* event, QAbstractItemModel* model, const QStyleOptionViewItem& option, const QModelIndex& index) {
+    if (index.column() == ProductTableModel::AddColumn && event->type() == QEvent::MouseButtonRelease) {
+        QMouseEvent* mouseEvent = static_cast<QMouseEvent*>(event);
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+        QPoint position = mouseEvent->position().toPoint(); // pos() is deprecated in Qt 6
+#else
+        QPoint position = mouseEvent->pos();
+#endif
+        if (mouseEvent->button() == Qt::LeftButton && option.rect.contains(position)) {
+            emit addToCartClicked(index.row());
+            return true;
+        }
+    }
+    return QStyledItemDelegate::editorEvent(event, model, option, index);
+}
@@ -0,0 +1,71 @@
+#ifndef PRODUCT_TABLE_MODEL_H
+#define PRODUCT_TABLE_MODEL_H
+
+#include <QAbstractTableModel>
+#include <QStyledItemDelegate>
+#include <vector>
+
+using namespace std;
+
+struct ProductNode;
+class ThumbnailCache;
+
+// Table model over a list of catalog nodes (the whole catalog or a search
+// result). Rows only hold node pointers; text is produced on demand for the
+// rows the view paints, so opening a listing costs the same for 50 products
+// as for 50k. The same goes for thumbnails, which are only requested for
+// painted rows. The model has to be reset with setNodes after products are
+// removed from the catalog.
+class ProductTableModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    enum Column { CodeColumn, NameColumn, SkinTypeColumn, PriceColumn, StockColumn, AddQuantityColumn, AddColumn, ColumnCount };
+
+    explicit ProductTableModel(QObject* parent = nullptr);
+
+    void setNodes(vector<ProductNode*> nodes);
+    // Moves to nodes by removing and inserting only the rows that differ, so
+    // the view keeps its scroll position and selection. The lists can be in
+    // any order; falls back to a reset when nodes in both are ordered
+    // differently, or when the lists differ in many places.
+    void updateNodes(vector<ProductNode*> nodes);
+    // Shows product images next to their names
+    void setThumbnails(ThumbnailCache* thumbnails);
+    const ProductNode* nodeAt(int row) const { return nodes[row]; }
+    // Quantity chosen in the row's spin box, clamped to the stock
+    int addQuantity(int row) const;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+private:
+    vector<ProductNode*> nodes;
+    vector<int> addQuantities; // per row, starts at 1
+    ThumbnailCache* thumbnails;
+};
+
+// Supplies the per-row controls of a ProductTableModel without a widget per
+// row: the quantity spin box is an editor created only while a cell is being
+// edited, and the add-to-cart button is painted and hit-tested here.
+class ProductRowDelegate : public QStyledItemDelegate {
+    Q_OBJECT
+
+public:
+    explicit ProductRowDelegate(QObject* parent = nullptr);
+
+    QWidget* createEditor(QWidget* parent, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+    void setEditorData(QWidget* editor, const QModelIndex& index) const override;
+    void setModelData(QWidget* editor, QAbstractItemModel* model, const QModelIndex& index) const override;
+    void paint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index) const override;
+    bool editorEvent(QEvent* event, QAbstractItemModel* model, const QStyleOptionViewItem& option, const QModelIndex& index) override;
+
+signals:
+    void addToCartClicked(int row);
+};
+
+#endif // PRODUCT_TABLE_MODEL_H
@@ -0,0 +1,138 @@
+#include "search_panel.h"
+#include "taxonomy.h"
+#include <QComboBox>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QSignalBlocker>
+#include <QTimer>
+
+namespace {
+
+const int debounceMs = 150;
+
+// Entries of the match mode box, in order
+enum MatchMode { ContainsMode, WordStartMode, OneTypoMode, TwoTyposMode };
+
+QComboBox* facetBox(const vector<string>& values, QWidget* parent) {
+    QComboBox* box = new QComboBox(parent);
+    box->addItem(QObject::tr("Any"));
+    for (const string& value : values) {
+        box->addItem(QString::fromStdString(value));
+    }
+    return box;
+}
+
+// The selected value, or nothing while the box is on "Any"
+vector<string> facetValue(const QComboBox* box) {
+    if (box->currentIndex() <= 0) return {};
+    return {box->currentText().toStdString()};
+}
+
+}
+
+SearchPanel::SearchPanel(QWidget* parent) : QWidget(parent) {
+    const Taxonomy& taxonomy = Taxonomy::instance();
+    name = new QLineEdit(this);
+    name->setPlaceholderText(tr("Search by name"));
+    name->setClearButtonEnabled(true);
+    matchMode = new QComboBox(this);
+    matchMode->addItems({tr("Contains"), tr("Word start"), tr("1 typo"), tr("2 typos")});
+    category = facetBox(taxonomy.categoryNames(), this);
+    subCategory = facetBox({}, this);
+    skinType = facetBox(taxonomy.skinTypeNames(), this);
+    range = facetBox(taxonomy.rangeNames(), this);
+    resultCount = new QLabel(this);
+    fillSubCategories();
+
+    debounce = new QTimer(this);
+    debounce->setSingleShot(true);
+    debounce->setInterval(debounceMs);
+    connect(debounce, &QTimer::timeout, this, &SearchPanel::queryChanged);
+    connect(name, &QLineEdit::textChanged, debounce, qOverload<>(&QTimer::start));
+
+    connect(category, qOverload<int>(&QComboBox::currentIndexChanged), this, [this]() {
+        {
+            QSignalBlocker blocker(subCategory);
+            fillSubCategories();
+        }
+        queryEdited();
+    });
+    for (QComboBox* facet : {matchMode, subCategory, skinType, range}) {
+        connect(facet, qOverload<int>(&QComboBox::currentIndexChanged), this, &SearchPanel::queryEdited);
+    }
+
+    QHBoxLayout* layout = new QHBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(name, 2);
+    layout->addWidget(matchMode);
+    layout->addWidget(category, 1);
+    layout->addWidget(subCategory, 1);
+    layout->addWidget(skinType, 1);
+    layout->addWidget(range, 1);
+    layout->addWidget(resultCount);
+}
+
+CatalogQuery SearchPanel::query() const {
+    CatalogQuery query;
+    query.name = name->text().trimmed().toStdString();
+    query.nameMatch = matchMode->currentIndex() == WordStartMode ? NameMatch::Prefix : NameMatch::Substring;
+    query.fuzzy = matchMode->currentIndex() >= OneTypoMode;
+    query.maxEdits = matchMode->currentIndex() == TwoTyposMode ? 2 : 1;
+    query.filter.categories = facetValue(category);
+    query.filter.subCategories = facetValue(subCategory);
+    query.filter.skinTypes = facetValue(skinType);
+    query.filter.ranges = facetValue(range);
+    return query;
+}
+
+void SearchPanel::clear() {
+    debounce->stop();
+    for (QWidget* control : initializer_list<QWidget*>{name, matchMode, category, subCategory, skinType, range}) {
+        control->blockSignals(true);
+    }
+    name->clear();
+    matchMode->setCurrentIndex(ContainsMode);
+    category->setCurrentIndex(0);
+    fillSubCategories();
+    skinType->setCurrentIndex(0);
+    range->setCurrentIndex(0);
+    for (QWidget* control : initializer_list<QWidget*>{name, matchMode, category, subCategory, skinType, range}) {
+        control->blockSignals(false);
+    }
+}
+
+void SearchPanel::focusName() {
+    name->setFocus();
+    name->selectAll();
+}
+
+void SearchPanel::setResultCount(int count) {
+    resultCount->setText(tr("%n product(s)", "", count));
+}
+
+// Without a category every subcategory is offered
+void SearchPanel::fillSubCategories() {
+    const Taxonomy& taxonomy = Taxonomy::instance();
+    QString selected = subCategory->currentIndex() > 0 ? subCategory->currentText() : QString();
+    subCategory->clear();
+    subCategory->addItem(tr("Any"));
+    if (category->currentIndex() > 0) {
+        for (const string& value : taxonomy.subCategoryNames(category->currentText().toStdString())) {
+            subCategory->addItem(QString::fromStdString(value));
+        }
+    } else {
+        for (const string& categoryName : taxonomy.categoryNames()) {
+            for (const string& value : taxonomy.subCategoryNames(categoryName)) {
+                subCategory->addItem(QString::fromStdString(value));
+            }
+        }
+    }
+    subCategory->setCurrentIndex(max(0, subCategory->findText(selected)));
+}
+
+// Match mode and facet changes don't need debouncing; they also flush pending typing
+void SearchPanel::queryEdited() {
+    debounce->stop();
+    emit queryChanged();
+}
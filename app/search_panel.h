@@ -0,0 +1,45 @@
+#ifndef SEARCH_PANEL_H
+#define SEARCH_PANEL_H
+
+#include "catalog_search.h"
+#include <QWidget>
+
+class QComboBox;
+class QLabel;
+class QLineEdit;
+class QTimer;
+
+// Inline search controls above the product table: a name box, how the name
+// has to match (anywhere, at the start of a word, or allowing typos), and one
+// combo box per facet. Typing is debounced so a burst of keystrokes runs one query;
+// facet changes run it straight away.
+class SearchPanel : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit SearchPanel(QWidget* parent = nullptr);
+
+    CatalogQuery query() const;
+    // Back to matching every product, without emitting queryChanged
+    void clear();
+    void focusName();
+    void setResultCount(int count);
+
+signals:
+    void queryChanged();
+
+private:
+    QLineEdit* name;
+    QComboBox* matchMode;
+    QComboBox* category;
+    QComboBox* subCategory;
+    QComboBox* skinType;
+    QComboBox* range;
+    QLabel* resultCount;
+    QTimer* debounce;
+
+    void fillSubCategories();
+    void queryEdited();
+};
+
+#endif // SEARCH_PANEL_H
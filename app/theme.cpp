@@ -0,0 +1,24 @@
+#include "theme.h"
+#include <QApplication>
+
+void applyTheme(QApplication& app) {
+    app.setStyleSheet(QStringLiteral(
+        // Light red background for windows and dialogs
+        "QMainWindow, QDialog { background-color: #FFCDD2; }"
+        "QTableView { background-color: #FFCDD2; }"
+        "QHeaderView::section { background-color: #8B0000; color: white; padding: 5px; }"
+
+        // Lighter red buttons
+        "QPushButton[role=\"primary\"] { background-color: #CD5C5C; color: white; font-weight: bold; border-radius: 15px; padding: 15px; }"
+        "QPushButton[role=\"tile\"] { background-color: #CD5C5C; color: white; border-radius: 15px; padding: 15px;"
+        " font-family: Roboto; font-size: 14pt; }"
+        "QPushButton[role=\"header\"] { background-color: #CD5C5C; color: white; font-weight: bold; border-radius: 15px;"
+        " padding: 10px; margin-left: 10px; font-family: Roboto; font-size: 14pt; }"
+
+        // Red titles
+        "QLabel[role=\"title\"] { color: #B22222; font-size: 16pt; font-weight: bold; }"
+        "QLabel#welcomeLabel { color: #B22222; font-family: Roboto; font-size: 40pt; font-weight: bold; }"
+
+        // Dark red panels with white text
+        "QTextEdit[role=\"details\"] { background-color: #8B0000; color: white; padding: 10px; }"));
+}
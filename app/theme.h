@@ -0,0 +1,16 @@
+#ifndef THEME_H
+#define THEME_H
+
+class QApplication;
+
+// The application's one stylesheet, applied once to the QApplication so no
+// widget carries its own. Variants are selected with the "role" dynamic
+// property or an object name:
+//     QPushButton  role = primary | tile | header
+//     QLabel       role = title, or the welcomeLabel object name
+//     QTextEdit    role = details
+// Dialogs, including the static QMessageBox/QInputDialog ones, pick up the
+// background from the QDialog rule.
+void applyTheme(QApplication& app);
+
+#endif // THEME_H
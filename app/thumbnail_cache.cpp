@@ -0,0 +1,121 @@
+#include "thumbnail_cache.h"
+#include "image_service.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QThread>
+#include <algorithm>
+
+namespace {
+
+// Rows scrolled past before their thumbnails were decoded are dropped rather
+// than decoded late; they are asked for again if they come back into view
+const size_t maxPendingRequests = 64;
+
+}
+
+ThumbnailCache::ThumbnailCache(const QSize& size, size_t memoryLimit, QObject* parent)
+    : QObject(parent), thumbnailSize(size), memoryLimit(memoryLimit), used(0) {
+    pool.setMaxThreadCount(max(1, QThread::idealThreadCount() - 1));
+}
+
+ThumbnailCache::~ThumbnailCache() {
+    {
+        lock_guard<mutex> guard(lock);
+        requests.clear();
+    }
+    pool.waitForDone();
+}
+
+void ThumbnailCache::setDiskCacheDirectory(const QString& directory) {
+    if (!directory.isEmpty()) {
+        QDir().mkpath(directory);
+    }
+    lock_guard<mutex> guard(lock);
+    diskDirectory = directory;
+}
+
+QPixmap ThumbnailCache::thumbnail(const QString& imagePath) {
+    auto found = entries.find(imagePath);
+    if (found != entries.end()) {
+        recency.splice(recency.begin(), recency, found->position);
+        return found->pixmap;
+    }
+    if (inFlight.contains(imagePath)) return QPixmap();
+
+    inFlight.insert(imagePath);
+    {
+        lock_guard<mutex> guard(lock);
+        requests.push_back(imagePath);
+        if (requests.size() > maxPendingRequests) {
+            inFlight.remove(requests.front());
+            requests.pop_front();
+        }
+    }
+    pool.start([this]() { decodeNext(); });
+    return QPixmap();
+}
+
+void ThumbnailCache::decodeNext() {
+    QString imagePath;
+    QString directory;
+    {
+        lock_guard<mutex> guard(lock);
+        if (requests.empty()) return;
+        // Newest first: those are the rows on screen now
+        imagePath = requests.back();
+        requests.pop_back();
+        directory = diskDirectory;
+    }
+
+    QString cachePath = directory.isEmpty() ? QString() : diskCachePath(directory, imagePath);
+    QImage image;
+    if (!cachePath.isEmpty() && QFileInfo::exists(cachePath)) {
+        image.load(cachePath);
+    }
+    if (image.isNull()) {
+        image = ImageService::decodeScaled(imagePath, thumbnailSize);
+        if (!image.isNull() && !cachePath.isEmpty()) {
+            image.save(cachePath, "PNG");
+        }
+    }
+    // QPixmaps can only be made on the GUI thread
+    QMetaObject::invokeMethod(this, [this, imagePath, image]() { finish(imagePath, image); }, Qt::QueuedConnection);
+}
+
+void ThumbnailCache::finish(const QString& imagePath, const QImage& image) {
+    inFlight.remove(imagePath);
+
+    // Failed decodes are cached too, as null pixmaps, so they aren't retried
+    // on every repaint
+    Entry entry;
+    entry.pixmap = QPixmap::fromImage(image);
+    entry.cost = image.isNull() ? 1 : static_cast<size_t>(image.sizeInBytes());
+    recency.push_front(imagePath);
+    entry.position = recency.begin();
+    entries.insert(imagePath, entry);
+    used += entry.cost;
+
+    while (used > memoryLimit && recency.size() > 1) {
+        auto evicted = entries.find(recency.back());
+        used -= evicted->cost;
+        entries.erase(evicted);
+        recency.pop_back();
+    }
+    emit thumbnailReady(imagePath);
+}
+
+QString ThumbnailCache::diskCachePath(const QString& directory, const QString& imagePath) const {
+    // Keyed by source path, modification time and size, so edited images
+    // and size changes get fresh thumbnails
+    QFileInfo source(imagePath);
+    QByteArray key = QStringLiteral("%1|%2|%3x%4")
+                         .arg(source.absoluteFilePath())
+                         .arg(source.lastModified().toMSecsSinceEpoch())
+                         .arg(thumbnailSize.width())
+                         .arg(thumbnailSize.height())
+                         .toUtf8();
+    QString name = QString::fromLatin1(QCryptographicHash::hash(key, QCryptographicHash::Sha1).toHex()) + QStringLiteral(".png");
+    return QDir(directory).filePath(name);
+}
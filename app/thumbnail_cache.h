@@ -0,0 +1,68 @@
+#ifndef THUMBNAIL_CACHE_H
+#define THUMBNAIL_CACHE_H
+
+#include <QHash>
+#include <QImage>
+#include <QObject>
+#include <QPixmap>
+#include <QSet>
+#include <QSize>
+#include <QString>
+#include <QThreadPool>
+#include <deque>
+#include <list>
+#include <mutex>
+
+using namespace std;
+
+// Product thumbnails for the product table. A thumbnail is asked for only
+// when a row is painted. Misses are decoded and downsampled on a QThreadPool
+// and kept in an LRU cache bounded by pixmap memory. Optionally the scaled
+// thumbnails are also written to a disk cache, so later sessions skip
+// decoding the full images.
+class ThumbnailCache : public QObject {
+    Q_OBJECT
+
+public:
+    ThumbnailCache(const QSize& size, size_t memoryLimit, QObject* parent = nullptr);
+    // Waits for decodes still running
+    ~ThumbnailCache();
+
+    // An empty directory turns the disk cache off (the default)
+    void setDiskCacheDirectory(const QString& directory);
+    QSize size() const { return thumbnailSize; }
+    size_t memoryUsed() const { return used; }
+
+    // Returns the cached thumbnail, or a null pixmap after queuing a decode.
+    // thumbnailReady is emitted once the decode has finished.
+    QPixmap thumbnail(const QString& imagePath);
+
+signals:
+    void thumbnailReady(const QString& imagePath);
+
+private:
+    struct Entry {
+        QPixmap pixmap;
+        size_t cost;
+        list<QString>::iterator position;
+    };
+
+    QSize thumbnailSize;
+    size_t memoryLimit;
+    size_t used;
+    list<QString> recency; // most recently used first
+    QHash<QString, Entry> entries;
+    QSet<QString> inFlight; // requested and not finished yet
+
+    // Shared with the workers
+    mutex lock;
+    deque<QString> requests;
+    QString diskDirectory;
+    QThreadPool pool;
+
+    void decodeNext();
+    void finish(const QString& imagePath, const QImage& image);
+    QString diskCachePath(const QString& directory, const QString& imagePath) const;
+};
+
+#endif // THUMBNAIL_CACHE_H
@@ -0,0 +1,365 @@
+// Throughput of the catalog engine's data structures and startup paths.
+//     catalog_bench [--sizes 10000,100000,1000000] [--format json|csv] [--out file] [--seed n]
+// For every size it times ProductBST insert / find / remove with sequential
+// and random codes, UserList lookups, OrderQueue, Product and Order
+// serialization, and the two ways the catalog is loaded at startup: the first
+// run's text import and the steady-state snapshot load through CatalogLog.
+// Results go to stdout (or --out) as JSON or CSV; progress goes to stderr.
+
+#include "catalog_log.h"
+#include "catalog_snapshot.h"
+#include "models.h"
+#include "persistence_service.h"
+#include "taxonomy.h"
+#include <QTemporaryDir>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+struct Result {
+    string name;
+    size_t size;    // catalog size the run was made at
+    size_t ops;     // operations timed
+    size_t bytes;   // bytes produced or consumed, 0 when not meaningful
+    double seconds;
+};
+
+// Keeps the optimizer from dropping work whose result is otherwise unused
+volatile size_t sink;
+
+double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+const char* const brands[] = {"Aqua", "Lumina", "Velvet", "Pure", "Botanica", "Derma", "Glow", "Silk", "Nova", "Verde"};
+const char* const kinds[] = {"Cleanser", "Moisturizer", "Serum", "Toner", "Sunscreen", "Exfoliant", "Shampoo",
+                             "Conditioner", "Foundation", "Concealer", "Mascara", "Lipstick", "Primer", "Balm"};
+
+template <size_t N>
+const char* pick(const char* const (&words)[N], mt19937& random) {
+    return words[random() % N];
+}
+
+// Products with codes 1..count, attributes drawn from the real taxonomy
+vector<Product> makeProducts(size_t count, mt19937& random) {
+    const Taxonomy& taxonomy = Taxonomy::instance();
+    const vector<string>& categories = taxonomy.categoryNames();
+    const vector<string>& skinTypes = taxonomy.skinTypeNames();
+    const vector<string>& ranges = taxonomy.rangeNames();
+    vector<Product> products;
+    products.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const string& category = categories[random() % categories.size()];
+        const vector<string>& subCategories = taxonomy.subCategoryNames(category);
+        string name = pick(brands, random);
+        name += ' ';
+        name += pick(kinds, random);
+        name += ' ';
+        name += to_string(random() % 1000);
+        products.emplace_back(static_cast<int>(i + 1), name, category,
+                              subCategories.empty() ? string() : subCategories[random() % subCategories.size()],
+                              skinTypes[random() % skinTypes.size()], ranges[random() % ranges.size()],
+                              (random() % 10000) / 100.0 + 1.0, static_cast<int>(random() % 500));
+    }
+    return products;
+}
+
+// One order per ten products, each with one to five items
+vector<Order> makeOrders(const vector<Product>& products, mt19937& random) {
+    size_t count = max<size_t>(1, products.size() / 10);
+    vector<Order> orders;
+    orders.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        vector<Product> items;
+        size_t itemCount = 1 + random() % 5;
+        for (size_t j = 0; j < itemCount; ++j) {
+            items.push_back(products[random() % products.size()]);
+        }
+        string customer = "customer" + to_string(i);
+        orders.emplace_back(customer, to_string(i) + " Main Street", "0300" + to_string(1000000 + i),
+                            customer + "@example.com", items);
+        orders.back().placedAt = 1700000000 + static_cast<long long>(i);
+    }
+    return orders;
+}
+
+void benchProductTree(vector<Result>& results, const vector<Product>& products, mt19937& random) {
+    size_t n = products.size();
+    vector<int> sequential(n);
+    for (size_t i = 0; i < n; ++i) sequential[i] = products[i].code;
+    vector<int> shuffled = sequential;
+    shuffle(shuffled.begin(), shuffled.end(), random);
+    vector<const Product*> byShuffledCode(n);
+    for (size_t i = 0; i < n; ++i) byShuffledCode[i] = &products[shuffled[i] - 1];
+
+    auto timeFinds = [&](const char* name, ProductBST& tree, const vector<int>& codes) {
+        size_t found = 0;
+        auto start = chrono::steady_clock::now();
+        for (int code : codes) found += tree.findProduct(code) != nullptr;
+        results.push_back({name, n, codes.size(), 0, secondsSince(start)});
+        sink = found;
+    };
+
+    {
+        ProductBST tree;
+        auto start = chrono::steady_clock::now();
+        for (const Product& product : products) tree.addProduct(product);
+        results.push_back({"bst_insert_sequential", n, n, 0, secondsSince(start)});
+        timeFinds("bst_find_sequential", tree, sequential);
+        timeFinds("bst_find_random", tree, shuffled);
+        vector<int> missing(n);
+        for (size_t i = 0; i < n; ++i) missing[i] = -shuffled[i];
+        timeFinds("bst_find_missing", tree, missing);
+        start = chrono::steady_clock::now();
+        for (int code : sequential) tree.removeProduct(code);
+        results.push_back({"bst_remove_sequential", n, n, 0, secondsSince(start)});
+    }
+    {
+        ProductBST tree;
+        auto start = chrono::steady_clock::now();
+        for (const Product* product : byShuffledCode) tree.addProduct(*product);
+        results.push_back({"bst_insert_random", n, n, 0, secondsSince(start)});
+        shuffle(shuffled.begin(), shuffled.end(), random);
+        start = chrono::steady_clock::now();
+        for (int code : shuffled) tree.removeProduct(code);
+        results.push_back({"bst_remove_random", n, n, 0, secondsSince(start)});
+    }
+    {
+        ProductBST tree;
+        vector<Product> sorted = products;
+        auto start = chrono::steady_clock::now();
+        tree.buildFromSorted(sorted);
+        results.push_back({"bst_build_sorted", n, n, 0, secondsSince(start)});
+    }
+}
+
+void benchUsers(vector<Result>& results, size_t n, mt19937& random) {
+    vector<User> users;
+    users.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        users.emplace_back("user" + to_string(i), "password" + to_string(i), i % 100 == 0);
+    }
+    UserList list;
+    auto start = chrono::steady_clock::now();
+    for (const User& user : users) list.addUser(user);
+    results.push_back({"userlist_add", n, n, 0, secondsSince(start)});
+
+    vector<string> names(n);
+    for (size_t i = 0; i < n; ++i) names[i] = users[random() % n].username;
+    size_t found = 0;
+    start = chrono::steady_clock::now();
+    for (const string& name : names) found += list.findUser(name) != nullptr;
+    results.push_back({"userlist_find_hit", n, n, 0, secondsSince(start)});
+
+    for (string& name : names) name.insert(0, "missing-");
+    start = chrono::steady_clock::now();
+    for (const string& name : names) found += list.findUser(name) != nullptr;
+    results.push_back({"userlist_find_missing", n, n, 0, secondsSince(start)});
+    sink = found;
+}
+
+void benchOrders(vector<Result>& results, size_t n, const vector<Order>& orders) {
+    size_t m = orders.size();
+    OrderQueue queue;
+    auto start = chrono::steady_clock::now();
+    for (const Order& order : orders) queue.enqueue(order);
+    results.push_back({"orderqueue_enqueue", n, m, 0, secondsSince(start)});
+    Order order;
+    size_t items = 0;
+    start = chrono::steady_clock::now();
+    while (queue.dequeue(order)) items += order.products.size();
+    results.push_back({"orderqueue_dequeue", n, m, 0, secondsSince(start)});
+    sink = items;
+
+    vector<string> texts(m);
+    size_t bytes = 0;
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < m; ++i) {
+        orders[i].serializeTo(texts[i]);
+        bytes += texts[i].size();
+    }
+    results.push_back({"order_serialize", n, m, bytes, secondsSince(start)});
+
+    start = chrono::steady_clock::now();
+    for (const string& text : texts) items += Order::parse(text, order) == ParseError::None;
+    results.push_back({"order_parse", n, m, bytes, secondsSince(start)});
+    start = chrono::steady_clock::now();
+    for (const string& text : texts) items += Order::deserialize(text).products.size();
+    results.push_back({"order_deserialize", n, m, bytes, secondsSince(start)});
+    sink = items;
+}
+
+void benchProductText(vector<Result>& results, const vector<Product>& products) {
+    size_t n = products.size();
+    string text;
+    auto start = chrono::steady_clock::now();
+    for (const Product& product : products) product.serializeTo(text);
+    results.push_back({"product_serialize", n, n, text.size(), secondsSince(start)});
+
+    Product product;
+    size_t parsed = 0;
+    start = chrono::steady_clock::now();
+    for (size_t at = 0; at < text.size();) {
+        size_t end = text.find('\n', at);
+        parsed += Product::parse(string_view(text).substr(at, end - at), product) == ParseError::None;
+        at = end + 1;
+    }
+    results.push_back({"product_parse", n, n, text.size(), secondsSince(start)});
+
+    vector<string> lines;
+    lines.reserve(n);
+    for (size_t at = 0; at < text.size();) {
+        size_t end = text.find('\n', at);
+        lines.emplace_back(text, at, end - at);
+        at = end + 1;
+    }
+    start = chrono::steady_clock::now();
+    for (const string& line : lines) parsed += Product::deserialize(line).code != 0;
+    results.push_back({"product_deserialize", n, n, text.size(), secondsSince(start)});
+    sink = parsed;
+}
+
+size_t fileSize(const string& path) {
+    ifstream file(path, ios::binary | ios::ate);
+    return file.is_open() ? static_cast<size_t>(file.tellg()) : 0;
+}
+
+// The two paths MainWindow::loadProductsFromFile can take
+void benchStartup(vector<Result>& results, vector<Product>& products, const string& directory) {
+    size_t n = products.size();
+    string textPath = directory + "/products.txt";
+    string snapshotPath = directory + "/products.snapshot";
+    {
+        ProductBST tree;
+        vector<Product> sorted = products;
+        tree.buildFromSorted(sorted);
+        saveTextCatalog(textPath, tree);
+        ofstream snapshot(snapshotPath, ios::binary | ios::trunc);
+        snapshot << CatalogSnapshot::encode(tree);
+    }
+    {
+        // First run: no snapshot yet, the text catalog is imported
+        ProductBST tree;
+        auto start = chrono::steady_clock::now();
+        loadTextCatalog(textPath, tree);
+        results.push_back({"startup_text_import", n, tree.size(), fileSize(textPath), secondsSince(start)});
+    }
+    {
+        // Every later run: snapshot plus an empty log
+        PersistenceService persistence;
+        CatalogLog log(persistence, snapshotPath, directory + "/products.log", textPath);
+        ProductBST tree;
+        auto start = chrono::steady_clock::now();
+        log.load(tree);
+        results.push_back({"startup_snapshot", n, tree.size(), fileSize(snapshotPath), secondsSince(start)});
+    }
+}
+
+void printJson(FILE* out, const vector<Result>& results, unsigned seed) {
+    fprintf(out, "{\n  \"benchmark\": \"catalog_bench\",\n  \"seed\": %u,\n  \"timestamp\": %lld,\n  \"results\": [\n",
+            seed, static_cast<long long>(time(nullptr)));
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        double perOp = r.ops ? r.seconds * 1e9 / r.ops : 0.0;
+        double perSecond = r.seconds > 0 ? r.ops / r.seconds : 0.0;
+        fprintf(out, "    {\"name\": \"%s\", \"size\": %zu, \"ops\": %zu, \"bytes\": %zu, \"seconds\": %.6f, "
+                     "\"ns_per_op\": %.1f, \"ops_per_second\": %.0f}%s\n",
+                r.name.c_str(), r.size, r.ops, r.bytes, r.seconds, perOp, perSecond, i + 1 < results.size() ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+void printCsv(FILE* out, const vector<Result>& results) {
+    fprintf(out, "name,size,ops,bytes,seconds,ns_per_op,ops_per_second\n");
+    for (const Result& r : results) {
+        double perOp = r.ops ? r.seconds * 1e9 / r.ops : 0.0;
+        double perSecond = r.seconds > 0 ? r.ops / r.seconds : 0.0;
+        fprintf(out, "%s,%zu,%zu,%zu,%.6f,%.1f,%.0f\n", r.name.c_str(), r.size, r.ops, r.bytes, r.seconds, perOp, perSecond);
+    }
+}
+
+vector<size_t> parseSizes(const char* list) {
+    vector<size_t> sizes;
+    for (const char* at = list; *at;) {
+        char* end;
+        size_t size = strtoull(at, &end, 10);
+        if (end == at) break;
+        if (size > 0) sizes.push_back(size);
+        at = *end == ',' ? end + 1 : end;
+    }
+    return sizes;
+}
+
+void usage() {
+    fprintf(stderr, "usage: catalog_bench [--sizes 10000,100000,1000000] [--format json|csv] [--out file] [--seed n]\n");
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    vector<size_t> sizes = {10000, 100000, 1000000};
+    string format = "json";
+    const char* outPath = nullptr;
+    unsigned seed = 42;
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--sizes") && hasValue) {
+            sizes = parseSizes(argv[++i]);
+        } else if (!strcmp(argv[i], "--format") && hasValue) {
+            format = argv[++i];
+        } else if (!strcmp(argv[i], "--out") && hasValue) {
+            outPath = argv[++i];
+        } else if (!strcmp(argv[i], "--seed") && hasValue) {
+            seed = static_cast<unsigned>(strtoul(argv[++i], nullptr, 10));
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (sizes.empty() || (format != "json" && format != "csv")) {
+        usage();
+        return 2;
+    }
+
+    QTemporaryDir directory;
+    if (!directory.isValid()) {
+        fprintf(stderr, "catalog_bench: cannot create a temporary directory\n");
+        return 1;
+    }
+
+    vector<Result> results;
+    for (size_t n : sizes) {
+        fprintf(stderr, "size %zu\n", n);
+        mt19937 random(seed);
+        vector<Product> products = makeProducts(n, random);
+        benchProductTree(results, products, random);
+        benchUsers(results, n, random);
+        benchOrders(results, n, makeOrders(products, random));
+        benchProductText(results, products);
+        benchStartup(results, products, directory.path().toStdString());
+    }
+
+    FILE* out = outPath ? fopen(outPath, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "catalog_bench: cannot write %s\n", outPath);
+        return 1;
+    }
+    if (format == "csv") {
+        printCsv(out, results);
+    } else {
+        printJson(out, results, seed);
+    }
+    if (out != stdout) fclose(out);
+    return 0;
+}
@@ -0,0 +1,14 @@
+# Data structure and startup benchmark for the core library.
+#   qmake && make && ./catalog_bench --sizes 10000,100000,1000000,10000000 --format csv
+# Build in release mode; the timings of a debug build say little.
+
+TEMPLATE = app
+TARGET = catalog_bench
+CONFIG += console c++17 release
+CONFIG -= app_bundle
+QT = core
+
+include(../core/core.pri)
+
+SOURCES += \
+    catalog_bench.cpp
@@ -0,0 +1,231 @@
+// Writes a synthetic dataset the app loads like its own files.
+//     dataset_gen [--products n] [--users n] [--orders n] [--max-items n] [--seed n] [--out dir]
+// users.txt and products.txt hold one serialize() record per line and
+// orders.log holds framed Order records, exactly as the app writes them.
+// Products are spread over the whole category / subCategory taxonomy with
+// prices that follow their range; orders have one to max-items line items and
+// are placed over the past year, oldest first. User i is "user<i>" with
+// password "password<i>"; every 50th user, starting with user0, is staff.
+// Any products.bin or products.log in the output directory is removed, since
+// either would take precedence over the new products.txt.
+
+#include "models.h"
+#include "order_log.h"
+#include "taxonomy.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+// Small, fast generator, so a product can be recreated from its index alone
+struct SplitMix {
+    uint64_t state;
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+    size_t below(size_t bound) { return static_cast<size_t>(next() % bound); }
+};
+
+const char* const brands[] = {"Aqua", "Lumina", "Velvet", "Pure", "Botanica", "Derma", "Glow", "Silk", "Nova", "Verde",
+                              "Petal", "Cielo", "Amber", "Mira", "Sol", "Orchid", "Haven", "Bloom", "Luxe", "Zen"};
+const char* const qualifiers[] = {"Gentle", "Hydrating", "Daily", "Night", "Matte", "Radiance", "Repair", "Soothing",
+                                  "Clarifying", "Nourishing", "Ultra", "Classic", "Intense", "Fresh", "Velvet", "Pro"};
+const char* const sizes[] = {"15ml", "30ml", "50ml", "100ml", "150ml", "200ml", "250ml", "Travel Size", "Mini"};
+const char* const streets[] = {"Main", "Park", "Oak", "Maple", "Cedar", "Lake", "Hill", "Mall", "Canal", "Garden"};
+const char* const cities[] = {"Lahore", "Karachi", "Islamabad", "Multan", "Peshawar", "Quetta", "Faisalabad", "Sialkot"};
+
+template <size_t N>
+const char* pick(const char* const (&words)[N], SplitMix& random) {
+    return words[random.below(N)];
+}
+
+struct Generator {
+    uint64_t seed;
+    const Taxonomy& taxonomy = Taxonomy::instance();
+
+    // Codes rise with the index but leave gaps, as a real catalog would
+    static int codeOf(size_t index, uint64_t mix) { return static_cast<int>(2 * index + 1 + (mix & 1)); }
+
+    Product product(size_t index) const {
+        SplitMix random{seed ^ (index * 0xD1B54A32D192ED03ULL)};
+        const vector<string>& categories = taxonomy.categoryNames();
+        const string& category = categories[random.below(categories.size())];
+        const vector<string>& subCategories = taxonomy.subCategoryNames(category);
+        const string& subCategory = subCategories[random.below(subCategories.size())];
+        const vector<string>& skinTypes = taxonomy.skinTypeNames();
+        const vector<string>& ranges = taxonomy.rangeNames();
+        size_t rangeIndex = random.below(ranges.size());
+
+        string name = pick(brands, random);
+        name += ' ';
+        name += pick(qualifiers, random);
+        name += ' ';
+        name += subCategory;
+        name += ' ';
+        name += pick(sizes, random);
+
+        // Low, Medium and High ranges cost roughly 3-15, 15-40 and 40-150
+        static const double lowest[] = {3.0, 15.0, 40.0};
+        static const double spread[] = {12.0, 25.0, 110.0};
+        double price = lowest[rangeIndex % 3] + random.below(static_cast<size_t>(spread[rangeIndex % 3] * 100)) / 100.0;
+        int quantity = static_cast<int>(random.below(10) == 0 ? 0 : random.below(500) + 1);
+        return Product(codeOf(index, random.next()), name, category, subCategory,
+                       skinTypes[random.below(skinTypes.size())], ranges[rangeIndex], price, quantity);
+    }
+};
+
+// Appends to a file through one reused buffer
+class BufferedFile {
+public:
+    explicit BufferedFile(const string& path) : file(path, ios::binary | ios::trunc) {}
+    bool isOpen() const { return file.is_open(); }
+    string& buffer() { return pending; }
+    void flushIfFull() {
+        if (pending.size() >= 1024 * 1024) flush();
+    }
+    bool close() {
+        flush();
+        file.close();
+        return !file.fail();
+    }
+
+private:
+    ofstream file;
+    string pending;
+
+    void flush() {
+        file.write(pending.data(), static_cast<streamsize>(pending.size()));
+        pending.clear();
+    }
+};
+
+bool writeUsers(const string& path, size_t count) {
+    BufferedFile file(path);
+    if (!file.isOpen()) return false;
+    for (size_t i = 0; i < count; ++i) {
+        User(string("user") + to_string(i), string("password") + to_string(i), i % 50 == 0).serializeTo(file.buffer());
+        file.flushIfFull();
+    }
+    return file.close();
+}
+
+bool writeProducts(const string& path, const Generator& generator, size_t count) {
+    BufferedFile file(path);
+    if (!file.isOpen()) return false;
+    for (size_t i = 0; i < count; ++i) {
+        generator.product(i).serializeTo(file.buffer());
+        file.flushIfFull();
+    }
+    return file.close();
+}
+
+bool writeOrders(const string& path, const Generator& generator, size_t count, size_t productCount, size_t userCount, size_t maxItems) {
+    BufferedFile file(path);
+    if (!file.isOpen()) return false;
+    file.buffer() = OrderLogWriter::header();
+    SplitMix random{generator.seed ^ 0x6F72646572ULL};
+    long long yearAgo = static_cast<long long>(time(nullptr)) - 365LL * 24 * 60 * 60;
+    Order order;
+    for (size_t i = 0; i < count; ++i) {
+        string username = "user" + to_string(random.below(userCount));
+        order.customerName = username;
+        order.address = to_string(1 + random.below(400)) + " " + pick(streets, random) + " Street " + pick(cities, random);
+        order.contact = "03" + to_string(100000000 + random.below(900000000));
+        order.email = username + "@example.com";
+        order.placedAt = yearAgo + static_cast<long long>(i * (365.0 * 24 * 60 * 60) / count);
+        order.products.clear();
+        size_t items = 1 + random.below(maxItems);
+        for (size_t j = 0; j < items && productCount > 0; ++j) {
+            Product item = generator.product(random.below(productCount));
+            item.quantity = static_cast<int>(1 + random.below(3));
+            order.products.push_back(move(item));
+        }
+        OrderLogWriter::frameTo(file.buffer(), order);
+        file.flushIfFull();
+    }
+    return file.close();
+}
+
+bool parseCount(const char* text, size_t& value) {
+    char* end;
+    unsigned long long parsed = strtoull(text, &end, 10);
+    if (end == text || *end) return false;
+    value = static_cast<size_t>(parsed);
+    return true;
+}
+
+void usage() {
+    fprintf(stderr, "usage: dataset_gen [--products n] [--users n] [--orders n] [--max-items n] [--seed n] [--out dir]\n");
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t productCount = 1000000;
+    size_t userCount = 100000;
+    size_t orderCount = 200000;
+    size_t maxItems = 5;
+    size_t seed = 42;
+    string directory = ".";
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        bool ok = hasValue;
+        if (!strcmp(argv[i], "--products") && hasValue) {
+            ok = parseCount(argv[++i], productCount);
+        } else if (!strcmp(argv[i], "--users") && hasValue) {
+            ok = parseCount(argv[++i], userCount);
+        } else if (!strcmp(argv[i], "--orders") && hasValue) {
+            ok = parseCount(argv[++i], orderCount);
+        } else if (!strcmp(argv[i], "--max-items") && hasValue) {
+            ok = parseCount(argv[++i], maxItems);
+        } else if (!strcmp(argv[i], "--seed") && hasValue) {
+            ok = parseCount(argv[++i], seed);
+        } else if (!strcmp(argv[i], "--out") && hasValue) {
+            directory = argv[++i];
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            usage();
+            return 2;
+        }
+    }
+    if (userCount == 0 || maxItems == 0 || productCount > 1000000000) {
+        usage();
+        return 2;
+    }
+
+    Generator generator{seed};
+    string base = directory + "/";
+    remove((base + "products.bin").c_str());
+    remove((base + "products.log").c_str());
+
+    fprintf(stderr, "writing %zu users\n", userCount);
+    if (!writeUsers(base + "users.txt", userCount)) {
+        fprintf(stderr, "dataset_gen: cannot write %susers.txt\n", base.c_str());
+        return 1;
+    }
+    fprintf(stderr, "writing %zu products\n", productCount);
+    if (!writeProducts(base + "products.txt", generator, productCount)) {
+        fprintf(stderr, "dataset_gen: cannot write %sproducts.txt\n", base.c_str());
+        return 1;
+    }
+    fprintf(stderr, "writing %zu orders\n", orderCount);
+    if (!writeOrders(base + "orders.log", generator, orderCount, productCount, userCount, maxItems)) {
+        fprintf(stderr, "dataset_gen: cannot write %sorders.log\n", base.c_str());
+        return 1;
+    }
+    return 0;
+}
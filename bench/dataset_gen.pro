@@ -0,0 +1,13 @@
+# Synthetic dataset generator: users.txt, products.txt and orders.log.
+#   qmake && make && ./dataset_gen --products 5000000 --users 200000 --orders 1000000 --out data
+
+TEMPLATE = app
+TARGET = dataset_gen
+CONFIG += console c++17 release
+CONFIG -= app_bundle
+QT = core
+
+include(../core/core.pri)
+
+SOURCES += \
+    dataset_gen.cpp
@@ -0,0 +1,125 @@
+// Throughput of fuzzy name search over a synthetic catalog.
+//     fuzzy_bench [names] [queries]
+// Builds a trigram index over generated product names, then searches it with
+// misspelled queries at 1 and 2 typos, and times raw verification of every
+// name with and without the four-lane distance4 path.
+
+#include "fuzzy_match.h"
+#include "name_index.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+const char* const brands[] = {"Aqua", "Lumina", "Velvet", "Pure", "Botanica", "Derma", "Glow", "Silk", "Nova", "Verde"};
+const char* const products[] = {"Cleanser", "Moisturizer", "Serum", "Toner", "Sunscreen", "Exfoliant", "Shampoo",
+                                "Conditioner", "Foundation", "Concealer", "Mascara", "Lipstick", "Primer", "Balm"};
+const char* const qualifiers[] = {"Gentle", "Hydrating", "Daily", "Night", "Matte", "Radiance", "Repair", "Soothing"};
+
+template <size_t N>
+const char* pick(const char* const (&words)[N], mt19937& random) {
+    return words[random() % N];
+}
+
+string makeName(mt19937& random) {
+    string name = pick(brands, random);
+    name += ' ';
+    name += pick(qualifiers, random);
+    name += ' ';
+    name += pick(products, random);
+    name += ' ';
+    name += to_string(random() % 1000);
+    return name;
+}
+
+// Applies edits random substitutions, deletions or insertions
+string misspell(string word, int edits, mt19937& random) {
+    for (int i = 0; i < edits && !word.empty(); ++i) {
+        size_t at = random() % word.size();
+        char letter = static_cast<char>('a' + random() % 26);
+        switch (random() % 3) {
+        case 0:
+            word[at] = letter;
+            break;
+        case 1:
+            word.erase(at, 1);
+            break;
+        default:
+            word.insert(word.begin() + at, letter);
+            break;
+        }
+    }
+    return word;
+}
+
+double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    size_t nameCount = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+    int queryCount = argc > 2 ? atoi(argv[2]) : 200;
+    mt19937 random(42);
+
+    vector<string> names;
+    names.reserve(nameCount);
+    for (size_t i = 0; i < nameCount; ++i) names.push_back(makeName(random));
+
+    auto start = chrono::steady_clock::now();
+    TrigramIndex index;
+    for (size_t i = 0; i < names.size(); ++i) index.insert(static_cast<uint32_t>(i), names[i]);
+    printf("names: %zu, index build: %.3f s, trigrams: %zu\n", names.size(), secondsSince(start), index.trigramCount());
+#if defined(FUZZY_AVX2) && defined(__AVX2__)
+    printf("verification: AVX2, four lanes\n");
+#else
+    printf("verification: scalar\n");
+#endif
+
+    auto nameOf = [&](uint32_t slot) { return &names[slot]; };
+    for (int edits = 1; edits <= 2; ++edits) {
+        vector<string> queries;
+        for (int i = 0; i < queryCount; ++i) {
+            string word = random() % 2 ? pick(products, random) : pick(qualifiers, random);
+            queries.push_back(misspell(normalizeName(word), edits, random));
+        }
+        size_t found = 0;
+        start = chrono::steady_clock::now();
+        for (const string& query : queries) {
+            found += fuzzySearch(index, names.size(), nameOf, query, edits, 10).size();
+        }
+        double seconds = secondsSince(start);
+        printf("top-10 search, %d typo(s): %.3f ms/query, %.0f names/s, %zu hits\n", edits, seconds * 1000 / queries.size(),
+               names.size() * queries.size() / seconds, found);
+    }
+
+    // Verification alone, on every name: distance() one at a time against distance4()
+    FuzzyMatcher matcher("moisturiser");
+    vector<string> normalized;
+    normalized.reserve(names.size());
+    for (const string& name : names) normalized.push_back(normalizeName(name));
+    const int bound = 64;
+    long long checksum = 0;
+    start = chrono::steady_clock::now();
+    for (const string& name : normalized) checksum += matcher.distance(name, bound);
+    double scalarSeconds = secondsSince(start);
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i + 4 <= normalized.size(); i += 4) {
+        string_view texts[4] = {normalized[i], normalized[i + 1], normalized[i + 2], normalized[i + 3]};
+        int distances[4];
+        matcher.distance4(texts, bound, distances);
+        checksum -= distances[0] + distances[1] + distances[2] + distances[3];
+    }
+    double batchSeconds = secondsSince(start);
+    for (size_t i = normalized.size() / 4 * 4; i < normalized.size(); ++i) checksum -= matcher.distance(normalized[i], bound);
+    printf("verify all names: distance %.0f names/s, distance4 %.0f names/s%s\n", normalized.size() / scalarSeconds,
+           normalized.size() / batchSeconds, checksum == 0 ? "" : " (MISMATCH)");
+    return checksum == 0 ? 0 : 1;
+}
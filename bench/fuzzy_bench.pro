@@ -0,0 +1,25 @@
+# Fuzzy name search benchmark; plain C++, no Qt modules needed.
+#   qmake && make && ./fuzzy_bench [names] [queries]
+# Add CONFIG+=fuzzy_avx2 to qmake to time the AVX2 verification path.
+
+TEMPLATE = app
+TARGET = fuzzy_bench
+CONFIG += console c++17 release
+CONFIG -= qt app_bundle
+
+fuzzy_avx2 {
+    DEFINES += FUZZY_AVX2
+    QMAKE_CXXFLAGS += -mavx2
+}
+
+# Only the two plain C++ sources it needs, rather than all of core.pri
+INCLUDEPATH += ../core
+
+SOURCES += \
+    fuzzy_bench.cpp \
+    ../core/fuzzy_match.cpp \
+    ../core/name_index.cpp
+
+HEADERS += \
+    ../core/fuzzy_match.h \
+    ../core/name_index.h
@@ -0,0 +1,403 @@
+// Drives MainWindow headlessly over a dataset and measures each user action.
+//     ui_harness --data dir [--repeat n] [--query text]... [--user name --password text]
+//                [--format json|csv] [--out file]
+// Runs against the files in dir (see dataset_gen), which it changes: every
+// checkout is appended to orders.log, so point it at a copy. Operations are
+// startup (constructing and showing the window), loaded (from then until users
+// and products have loaded), login, displayProducts, searchProducts (once per
+// query), checkout and viewOrders (the first one waits for the order history
+// to load). Each one reports wall time, the peak resident set size reached
+// while it ran, and the number and bytes of operator new calls. The window is
+// rendered with the offscreen platform unless QT_QPA_PLATFORM says otherwise;
+// modal dialogs are answered by a timer as they appear.
+
+#include "mainwindow.h"
+#include "models.h"
+#include "search_panel.h"
+#include "theme.h"
+#include <QApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QInputDialog>
+#include <QLineEdit>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QTest>
+#include <QTimer>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <string>
+#include <vector>
+
+#if defined(Q_OS_WIN)
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+using namespace std;
+
+// Every operator new in the process, including Qt's, goes through these
+static atomic<size_t> allocationCount{0};
+static atomic<size_t> allocationBytes{0};
+
+void* operator new(size_t size) {
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    allocationBytes.fetch_add(size, memory_order_relaxed);
+    if (void* block = malloc(size ? size : 1)) return block;
+    throw bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* block) noexcept {
+    free(block);
+}
+
+void operator delete[](void* block) noexcept {
+    free(block);
+}
+
+void operator delete(void* block, size_t) noexcept {
+    free(block);
+}
+
+void operator delete[](void* block, size_t) noexcept {
+    free(block);
+}
+
+namespace {
+
+// Starts a new peak where the platform allows it (Linux); elsewhere the peak
+// is the process's so far
+void resetPeakRss() {
+#if defined(Q_OS_LINUX)
+    ofstream("/proc/self/clear_refs") << "5";
+#endif
+}
+
+size_t peakRssKb() {
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return counters.PeakWorkingSetSize / 1024;
+    return 0;
+#else
+#if defined(Q_OS_LINUX)
+    ifstream status("/proc/self/status");
+    string line;
+    while (getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) return strtoull(line.c_str() + 6, nullptr, 10);
+    }
+#endif
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(Q_OS_MACOS)
+    return static_cast<size_t>(usage.ru_maxrss) / 1024; // bytes on macOS
+#else
+    return static_cast<size_t>(usage.ru_maxrss);
+#endif
+#endif
+}
+
+struct Sample {
+    double milliseconds;
+    size_t peakRssKb;
+    size_t allocations;
+    size_t allocatedBytes;
+};
+
+struct Operation {
+    string name;
+    vector<Sample> samples;
+};
+
+template <typename Action>
+Sample measure(Action action) {
+    resetPeakRss();
+    size_t count = allocationCount.load();
+    size_t bytes = allocationBytes.load();
+    QElapsedTimer timer;
+    timer.start();
+    action();
+    // Include the layout and painting the action caused
+    QApplication::processEvents();
+    double milliseconds = timer.nsecsElapsed() / 1e6;
+    return {milliseconds, peakRssKb(), allocationCount.load() - count, allocationBytes.load() - bytes};
+}
+
+// Answers modal dialogs as they open: input dialogs get the next queued
+// answer, message boxes are acknowledged
+class DialogAnswerer : public QObject {
+public:
+    DialogAnswerer() {
+        timer.setInterval(0);
+        connect(&timer, &QTimer::timeout, this, &DialogAnswerer::answer);
+        timer.start();
+    }
+    void queue(const QStringList& texts) { answers += texts; }
+
+private:
+    QTimer timer;
+    QStringList answers;
+
+    void answer() {
+        QWidget* modal = QApplication::activeModalWidget();
+        if (QInputDialog* input = qobject_cast<QInputDialog*>(modal)) {
+            if (!answers.isEmpty()) input->setTextValue(answers.takeFirst());
+            input->accept();
+        } else if (QMessageBox* box = qobject_cast<QMessageBox*>(modal)) {
+            box->accept();
+        }
+    }
+};
+
+void invoke(QObject* target, const char* slot) {
+    if (!QMetaObject::invokeMethod(target, slot)) {
+        fprintf(stderr, "ui_harness: cannot invoke %s\n", slot);
+        exit(1);
+    }
+}
+
+QPushButton* visibleButton(QWidget* window, const QString& text) {
+    for (QPushButton* button : window->findChildren<QPushButton*>()) {
+        if (button->text() == text && button->isVisible()) return button;
+    }
+    return nullptr;
+}
+
+// A few catalog records for the cart, read the same way the app imports them
+vector<Product> cartProducts(size_t count) {
+    vector<Product> products;
+    ifstream file("products.txt");
+    string line;
+    Product product;
+    while (products.size() < count && getline(file, line)) {
+        if (Product::parse(line, product) != ParseError::None) continue;
+        product.quantity = 1;
+        products.push_back(product);
+    }
+    return products;
+}
+
+double percentile(vector<double> values, double fraction) {
+    sort(values.begin(), values.end());
+    size_t index = static_cast<size_t>(fraction * (values.size() - 1) + 0.5);
+    return values[index];
+}
+
+struct Summary {
+    double median;
+    double min;
+    double max;
+    size_t peakRssKb;
+    size_t allocations;
+    size_t allocatedBytes;
+};
+
+Summary summarize(const Operation& operation) {
+    vector<double> times;
+    Summary summary{0, 0, 0, 0, 0, 0};
+    for (const Sample& sample : operation.samples) {
+        times.push_back(sample.milliseconds);
+        summary.peakRssKb = max(summary.peakRssKb, sample.peakRssKb);
+        summary.allocations += sample.allocations;
+        summary.allocatedBytes += sample.allocatedBytes;
+    }
+    summary.median = percentile(times, 0.5);
+    summary.min = *min_element(times.begin(), times.end());
+    summary.max = *max_element(times.begin(), times.end());
+    summary.allocations /= operation.samples.size();
+    summary.allocatedBytes /= operation.samples.size();
+    return summary;
+}
+
+// JSON string escaping for operation names, which include search queries
+string quoted(const string& text) {
+    string out = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') out += '\\';
+        if (static_cast<unsigned char>(c) >= 0x20) out += c;
+    }
+    return out + '"';
+}
+
+void printJson(FILE* out, const vector<Operation>& operations, const QString& data) {
+    fprintf(out, "{\n  \"benchmark\": \"ui_harness\",\n  \"data\": %s,\n  \"operations\": [\n", quoted(data.toStdString()).c_str());
+    for (size_t i = 0; i < operations.size(); ++i) {
+        Summary s = summarize(operations[i]);
+        fprintf(out, "    {\"name\": %s, \"runs\": %zu, \"median_ms\": %.3f, \"min_ms\": %.3f, \"max_ms\": %.3f, "
+                     "\"peak_rss_kb\": %zu, \"allocations\": %zu, \"allocated_bytes\": %zu}%s\n",
+                quoted(operations[i].name).c_str(), operations[i].samples.size(), s.median, s.min, s.max, s.peakRssKb,
+                s.allocations, s.allocatedBytes, i + 1 < operations.size() ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+void printCsv(FILE* out, const vector<Operation>& operations) {
+    fprintf(out, "name,runs,median_ms,min_ms,max_ms,peak_rss_kb,allocations,allocated_bytes\n");
+    for (const Operation& operation : operations) {
+        Summary s = summarize(operation);
+        string name = operation.name;
+        replace(name.begin(), name.end(), ',', ' ');
+        fprintf(out, "%s,%zu,%.3f,%.3f,%.3f,%zu,%zu,%zu\n", name.c_str(), operation.samples.size(), s.median, s.min, s.max,
+                s.peakRssKb, s.allocations, s.allocatedBytes);
+    }
+}
+
+void usage() {
+    fprintf(stderr, "usage: ui_harness --data dir [--repeat n] [--query text]... [--user name --password text]\n"
+                    "                  [--format json|csv] [--out file]\n");
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    QString data;
+    int repeat = 5;
+    QStringList queries;
+    QString username = "user1";
+    QString password = "password1";
+    string format = "json";
+    QString outPath;
+    for (int i = 1; i < argc; ++i) {
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--data") && hasValue) {
+            data = QString::fromLocal8Bit(argv[++i]);
+        } else if (!strcmp(argv[i], "--repeat") && hasValue) {
+            repeat = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--query") && hasValue) {
+            queries << QString::fromLocal8Bit(argv[++i]);
+        } else if (!strcmp(argv[i], "--user") && hasValue) {
+            username = QString::fromLocal8Bit(argv[++i]);
+        } else if (!strcmp(argv[i], "--password") && hasValue) {
+            password = QString::fromLocal8Bit(argv[++i]);
+        } else if (!strcmp(argv[i], "--format") && hasValue) {
+            format = argv[++i];
+        } else if (!strcmp(argv[i], "--out") && hasValue) {
+            // Made absolute before changing into the data directory
+            outPath = QFileInfo(QString::fromLocal8Bit(argv[++i])).absoluteFilePath();
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (data.isEmpty() || repeat < 1 || (format != "json" && format != "csv")) {
+        usage();
+        return 2;
+    }
+    if (!QDir::setCurrent(data)) {
+        fprintf(stderr, "ui_harness: no such directory %s\n", qPrintable(data));
+        return 1;
+    }
+    if (queries.isEmpty()) {
+        queries << "s" << "se" << "serum" << "Glow Night" << "moistrizer";
+    }
+    applyTheme(app);
+
+    vector<Operation> operations;
+    auto record = [&](const string& name, const Sample& sample) {
+        auto it = find_if(operations.begin(), operations.end(), [&](const Operation& o) { return o.name == name; });
+        if (it == operations.end()) it = operations.insert(operations.end(), Operation{name, {}});
+        it->samples.push_back(sample);
+        fprintf(stderr, "%s: %.1f ms\n", name.c_str(), sample.milliseconds);
+    };
+
+    DialogAnswerer answerer;
+    MainWindow* window = nullptr;
+    record("startup", measure([&]() {
+        window = new MainWindow;
+        window->show();
+    }));
+    auto waitFor = [&](MainWindow::Store store) {
+        while (!window->isLoaded(store)) {
+            QApplication::processEvents(QEventLoop::WaitForMoreEvents);
+        }
+    };
+    record("loaded", measure([&]() {
+        waitFor(MainWindow::Users);
+        waitFor(MainWindow::Products);
+    }));
+
+    answerer.queue({username, password});
+    record("login", measure([&]() { invoke(window, "on_loginButton_clicked"); }));
+    if (!visibleButton(window, "Logout")) {
+        fprintf(stderr, "ui_harness: cannot log in as %s\n", qPrintable(username));
+        return 1;
+    }
+
+    for (int run = 0; run < repeat; ++run) {
+        record("displayProducts", measure([&]() { invoke(window, "on_displayProductsButton_clicked"); }));
+    }
+
+    // The debounce timer is skipped: typing is timed, then the query runs at once
+    for (int run = 0; run < repeat; ++run) {
+        for (const QString& query : queries) {
+            invoke(window, "on_searchProductsButton_clicked");
+            SearchPanel* panel = window->findChild<SearchPanel*>();
+            QLineEdit* name = panel ? panel->findChild<QLineEdit*>() : nullptr;
+            QTimer* debounce = panel ? panel->findChild<QTimer*>(QString(), Qt::FindDirectChildrenOnly) : nullptr;
+            if (!name || !debounce) {
+                fprintf(stderr, "ui_harness: search panel not found\n");
+                return 1;
+            }
+            name->clear();
+            QApplication::processEvents();
+            record("searchProducts:" + query.toStdString(), measure([&]() {
+                QTest::keyClicks(name, query);
+                debounce->stop();
+                emit panel->queryChanged();
+            }));
+        }
+    }
+
+    vector<Product> items = cartProducts(3);
+    for (int run = 0; run < repeat; ++run) {
+        for (const Product& item : items) window->addToCart(item);
+        invoke(window, "on_viewCartButton_clicked");
+        QApplication::processEvents();
+        QPushButton* checkout = visibleButton(window, "Checkout");
+        if (!checkout) {
+            fprintf(stderr, "ui_harness: checkout button not found\n");
+            return 1;
+        }
+        answerer.queue({"Harness Customer", "1 Main Street", "03001234567", "harness@example.com"});
+        record("checkout", measure([&]() { QTest::mouseClick(checkout, Qt::LeftButton); }));
+    }
+
+    for (int run = 0; run < repeat; ++run) {
+        record("viewOrders", measure([&]() {
+            invoke(window, "on_viewOrdersButton_clicked");
+            waitFor(MainWindow::Orders);
+        }));
+    }
+
+    record("shutdown", measure([&]() { delete window; }));
+
+    FILE* out = outPath.isEmpty() ? stdout : fopen(QFile::encodeName(outPath).constData(), "w");
+    if (!out) {
+        fprintf(stderr, "ui_harness: cannot write %s\n", qPrintable(outPath));
+        return 1;
+    }
+    if (format == "csv") {
+        printCsv(out, operations);
+    } else {
+        printJson(out, operations, data);
+    }
+    if (out != stdout) fclose(out);
+    return 0;
+}
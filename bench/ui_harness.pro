@@ -0,0 +1,16 @@
+# Headless end-to-end harness: runs MainWindow over a generated dataset.
+#   qmake && make && ./ui_harness --data data-copy --format csv
+
+TEMPLATE = app
+TARGET = ui_harness
+CONFIG += console c++17 release
+CONFIG -= app_bundle
+QT += core gui widgets testlib
+
+include(../core/core.pri)
+include(../app/app.pri)
+
+win32: LIBS += -lpsapi
+
+SOURCES += \
+    ui_harness.cpp
@@ -0,0 +1,158 @@
+#include "catalog_log.h"
+#include "models.h"
+#include "catalog_snapshot.h"
+#include "log.h"
+#include "metrics.h"
+#include "persistence_service.h"
+#include "trace.h"
+#include <filesystem>
+#include <fstream>
+
+using namespace std;
+
+CatalogLog::CatalogLog(PersistenceService& persistence, const string& snapshotPath, const string& logPath, const string& textImportPath)
+    : persistence(persistence), snapshotPath(snapshotPath), logPath(logPath), textImportPath(textImportPath),
+      rotatedLogPath(logPath + ".old"), entries(0) {}
+
+void CatalogLog::load(ProductBST& products) {
+    SCOPED_LATENCY("CatalogLog::load");
+    CatalogSnapshot snapshot;
+    bool imported = false;
+    if (snapshot.open(snapshotPath)) {
+        snapshot.loadInto(products);
+        snapshot.close();
+    } else {
+        imported = loadTextCatalog(textImportPath, products);
+    }
+
+    // A rotated log only survives if the last compaction was interrupted
+    entries = 0;
+    replay(rotatedLogPath, products);
+    replay(logPath, products);
+    LOG_INFO(logCatalog) << "Catalog log replayed: " << entries << " records";
+
+    if (imported) {
+        compact(products);
+    }
+}
+
+// Every record ends with a line break, so a final line without one was torn
+// by a crash mid-append. Applying it could set the wrong quantity or delete
+// the wrong code, and the next append would be glued onto it, so it is
+// skipped and cut off the file before anything is appended again.
+void CatalogLog::replay(const string& path, ProductBST& products) {
+    TRACE_SPAN("CatalogLog::replay");
+    ifstream file(path, ios::binary);
+    string line;
+    Product product;
+    uint64_t complete = 0; // bytes in whole records so far
+    bool torn = false;
+    while (getline(file, line)) {
+        if (file.eof()) {
+            torn = true;
+            break;
+        }
+        complete += line.size() + 1;
+        if (line.size() < 2 || line[1] != ',') continue; // not a record
+        string_view body = string_view(line).substr(2);
+        ParseError error = ParseError::None;
+        switch (line[0]) {
+        case 'A':
+        case 'E':
+            error = Product::parse(body, product);
+            if (error == ParseError::None) {
+                products.addProduct(product);
+            }
+            break;
+        case 'D': {
+            int code;
+            if (!parseNumber(body, code)) {
+                error = ParseError::BadNumber;
+                break;
+            }
+            products.removeProduct(code);
+            break;
+        }
+        case 'Q': {
+            size_t comma = body.find(',');
+            int code;
+            int quantity;
+            if (comma == string_view::npos) {
+                error = ParseError::MissingField;
+                break;
+            }
+            if (!parseNumber(body.substr(0, comma), code) || !parseNumber(body.substr(comma + 1), quantity)) {
+                error = ParseError::BadNumber;
+                break;
+            }
+            Product* existing = products.findProduct(code);
+            if (existing) {
+                existing->quantity = quantity;
+            }
+            break;
+        }
+        default:
+            continue;
+        }
+        if (error != ParseError::None) {
+            LOG_WARNING(logCatalog) << "Error replaying catalog log: " << parseErrorMessage(error);
+            continue;
+        }
+        ++entries;
+    }
+    file.close();
+
+    if (torn) {
+        error_code ec;
+        filesystem::resize_file(path, complete, ec);
+        if (ec) {
+            LOG_ERROR(logStorage) << "Unable to truncate " << path << ": " << ec.message();
+        } else {
+            LOG_WARNING(logCatalog) << "Dropped a record torn by a crash at the end of " << path;
+        }
+    }
+}
+
+void CatalogLog::append() {
+    persistence.append(logPath, move(record));
+    ++entries;
+}
+
+void CatalogLog::recordAdd(const Product& product) {
+    record.assign("A,");
+    product.serializeTo(record);
+    append();
+}
+
+void CatalogLog::recordEdit(const Product& product) {
+    record.assign("E,");
+    product.serializeTo(record);
+    append();
+}
+
+void CatalogLog::recordDelete(int code) {
+    record.assign("D,");
+    record += to_string(code);
+    record += '\n';
+    append();
+}
+
+void CatalogLog::recordQuantity(int code, int quantity) {
+    record.assign("Q,");
+    record += to_string(code);
+    record += ',';
+    record += to_string(quantity);
+    record += '\n';
+    append();
+}
+
+bool CatalogLog::needsCompaction(size_t catalogSize) const {
+    return entries >= max<size_t>(1000, catalogSize / 2);
+}
+
+void CatalogLog::compact(const ProductBST& products) {
+    SCOPED_LATENCY("CatalogLog::compact");
+    // Capture the catalog in memory; the disk work happens on the writer thread
+    persistence.saveCatalog(snapshotPath, logPath, rotatedLogPath, CatalogSnapshot::encode(products));
+    entries = 0;
+}
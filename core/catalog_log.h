@@ -0,0 +1,55 @@
+#ifndef CATALOG_LOG_H
+#define CATALOG_LOG_H
+
+#include <string>
+
+using namespace std;
+
+class PersistenceService;
+class Product;
+class ProductBST;
+
+// Write-ahead log for the product catalog. Every mutation is appended to the
+// log as one line instead of rewriting the whole catalog:
+//     A,<product>        add (or replace) a product
+//     E,<product>        edit a product
+//     D,<code>           delete a product
+//     Q,<code>,<qty>     set a product's quantity
+// Every record sets state rather than adjusting it, so replaying a record
+// twice is harmless. Compaction rotates the log aside, writes a fresh
+// snapshot and then drops the rotated log. Startup replays snapshot + rotated
+// log (if a compaction was interrupted) + log; a final record torn by a crash
+// is skipped and cut off the log. All writes are handed to the
+// PersistenceService, so they happen off the GUI thread and in order.
+// The snapshot is a binary CatalogSnapshot; when it doesn't exist yet the
+// catalog is imported from the text file instead and a snapshot is written.
+class CatalogLog {
+public:
+    CatalogLog(PersistenceService& persistence, const string& snapshotPath, const string& logPath, const string& textImportPath);
+
+    void load(ProductBST& products);
+
+    void recordAdd(const Product& product);
+    void recordEdit(const Product& product);
+    void recordDelete(int code);
+    void recordQuantity(int code, int quantity);
+
+    // True once the log is long enough relative to the catalog that replaying
+    // it would cost more than rewriting the snapshot
+    bool needsCompaction(size_t catalogSize) const;
+    void compact(const ProductBST& products);
+
+private:
+    PersistenceService& persistence;
+    string snapshotPath;
+    string logPath;
+    string textImportPath;
+    string rotatedLogPath;
+    string record; // the record being appended
+    size_t entries;
+
+    void append();
+    void replay(const string& path, ProductBST& products);
+};
+
+#endif // CATALOG_LOG_H
@@ -0,0 +1,144 @@
+#include "catalog_search.h"
+#include "models.h"
+#include "taxonomy.h"
+#include "trace.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+
+// Every value of narrower is accepted by wider. An empty list accepts anything.
+bool isSubset(const vector<string>& narrower, const vector<string>& wider) {
+    if (wider.empty()) return true;
+    if (narrower.empty()) return false;
+    for (const string& value : narrower) {
+        if (find(wider.begin(), wider.end(), value) == wider.end()) return false;
+    }
+    return true;
+}
+
+// Ids of the known values, sorted. False when values is non-empty but none is known.
+bool compileValues(const AttributeDictionary& dictionary, const vector<string>& values, vector<uint16_t>& ids) {
+    for (const string& value : values) {
+        int id = dictionary.find(value);
+        if (id >= 0) ids.push_back(static_cast<uint16_t>(id));
+    }
+    sort(ids.begin(), ids.end());
+    return values.empty() || !ids.empty();
+}
+
+bool accepts(const vector<uint16_t>& ids, uint16_t id) {
+    return ids.empty() || binary_search(ids.begin(), ids.end(), id);
+}
+
+}
+
+CatalogSearch::CatalogSearch(const ProductBST& products) : products(products), revision(0), valid(false), narrowed(false) {}
+
+void CatalogSearch::reset() {
+    valid = false;
+    results.clear();
+}
+
+const vector<ProductNode*>& CatalogSearch::run(const CatalogQuery& query) {
+    TRACE_SPAN("CatalogSearch::run");
+    NameMatcher matcher(query.name, query.nameMatch);
+    CatalogQuery normalized = query;
+    normalized.name = matcher.query();
+    narrowed = valid && revision == products.revision() && narrows(normalized, matcher);
+
+    CompiledFilter filter = compile(normalized.filter);
+    const ProductFilter& facets = normalized.filter;
+    bool unfiltered = facets.categories.empty() && facets.subCategories.empty() && facets.skinTypes.empty() && facets.ranges.empty();
+    if (filter.matchesNothing) {
+        results.clear();
+    } else if (normalized.fuzzy && !normalized.name.empty()) {
+        // Typo-tolerant results are a top-k, which can't be narrowed later
+        if (unfiltered) {
+            results = products.fuzzySearch(normalized.name, normalized.maxEdits, fuzzyLimit);
+        } else {
+            results = products.fuzzySearch(normalized.name, normalized.maxEdits, fuzzyLimit, [&](const Product& product) {
+                return matches(product, filter);
+            });
+        }
+    } else if (narrowed || !normalized.name.empty()) {
+        // Name matches are ranked, so both paths collect hits and sort them
+        vector<NameHit> hits;
+        if (narrowed) {
+            for (ProductNode* node : results) {
+                if (!matches(node->product, filter)) continue;
+                NameMatcher::Rank rank = matcher.rank(node->product.name);
+                if (rank != NameMatcher::NoMatch) hits.push_back({node, rank});
+            }
+        } else {
+            // The name index finds the candidates; facets are checked on those only
+            hits = products.matchName(matcher);
+            if (!unfiltered) {
+                hits.erase(remove_if(hits.begin(), hits.end(), [&](const NameHit& hit) {
+                    return !matches(hit.node->product, filter);
+                }), hits.end());
+            }
+        }
+        if (!normalized.name.empty()) {
+            sort(hits.begin(), hits.end(), [](const NameHit& a, const NameHit& b) {
+                return a.rank != b.rank ? a.rank < b.rank : a.node->product.code < b.node->product.code;
+            });
+        }
+        results.clear();
+        for (const NameHit& hit : hits) results.push_back(hit.node);
+    } else {
+        // The bitmap index answers the facets. Without facets the tree walk is
+        // cheaper than sorting every slot.
+        results = unfiltered ? products.nodesInOrder() : products.query(facets);
+    }
+
+    lastQuery = move(normalized);
+    revision = products.revision();
+    valid = true;
+    return results;
+}
+
+bool CatalogSearch::narrows(const CatalogQuery& query, const NameMatcher& matcher) const {
+    if ((query.fuzzy && !query.name.empty()) || (lastQuery.fuzzy && !lastQuery.name.empty())) return false;
+    // Every name narrows an empty one, but rescanning a whole result set by
+    // name costs more than a trigram lookup once the name has a trigram
+    if (lastQuery.name.empty() && TrigramIndex::hasTrigrams(matcher)) return false;
+    const ProductFilter& previous = lastQuery.filter;
+    const ProductFilter& next = query.filter;
+    // A prefix match stops implying the shorter query once the text grows at
+    // the front, since the old text may then sit inside a word
+    bool nameNarrows = lastQuery.nameMatch == NameMatch::Substring ? query.name.find(lastQuery.name) != string::npos
+                                                                    : query.nameMatch == NameMatch::Prefix && query.name.compare(0, lastQuery.name.size(), lastQuery.name) == 0;
+    return nameNarrows &&
+           isSubset(next.categories, previous.categories) &&
+           isSubset(next.subCategories, previous.subCategories) &&
+           isSubset(next.skinTypes, previous.skinTypes) &&
+           isSubset(next.ranges, previous.ranges);
+}
+
+CatalogSearch::CompiledFilter CatalogSearch::compile(const ProductFilter& filter) {
+    const Taxonomy& taxonomy = Taxonomy::instance();
+    CompiledFilter compiled;
+    bool possible = compileValues(taxonomy.categories, filter.categories, compiled.categories) &&
+                    compileValues(taxonomy.subCategories, filter.subCategories, compiled.subCategories) &&
+                    compileValues(taxonomy.ranges, filter.ranges, compiled.ranges);
+
+    // Same skin type rule as ProductIndex: "All" on either side matches
+    if (possible && !filter.skinTypes.empty() && find(filter.skinTypes.begin(), filter.skinTypes.end(), "All") == filter.skinTypes.end()) {
+        compileValues(taxonomy.skinTypes, filter.skinTypes, compiled.skinTypes);
+        int all = taxonomy.skinTypes.find("All");
+        if (all >= 0) {
+            compiled.skinTypes.insert(lower_bound(compiled.skinTypes.begin(), compiled.skinTypes.end(), all), static_cast<uint16_t>(all));
+        }
+        possible = !compiled.skinTypes.empty();
+    }
+    compiled.matchesNothing = !possible;
+    return compiled;
+}
+
+bool CatalogSearch::matches(const Product& product, const CompiledFilter& filter) {
+    return !filter.matchesNothing && accepts(filter.categories, product.category) &&
+           accepts(filter.subCategories, product.subCategory) && accepts(filter.skinTypes, product.skinType) &&
+           accepts(filter.ranges, product.range);
+}
@@ -0,0 +1,69 @@
+#ifndef CATALOG_SEARCH_H
+#define CATALOG_SEARCH_H
+
+#include "name_index.h"
+#include "product_index.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+class Product;
+class ProductBST;
+
+// One search of the catalog: a name fragment plus the facet filter
+struct CatalogQuery {
+    string name; // empty matches every name
+    NameMatch nameMatch = NameMatch::Substring;
+    // Match names within maxEdits typos instead, closest first
+    bool fuzzy = false;
+    int maxEdits = 2;
+    ProductFilter filter;
+};
+
+// Runs the queries of the search-as-you-type panel. The last result is kept,
+// and a query that can only match a subset of it (the name fragment grew, or
+// a facet that was open got constrained) filters that result instead of going
+// back to the catalog. Any change to the catalog invalidates the result.
+class CatalogSearch {
+public:
+    static constexpr size_t fuzzyLimit = 200;
+
+    explicit CatalogSearch(const ProductBST& products);
+
+    // Nodes matching query. With a name they are ranked by how well it
+    // matches (see NameMatcher::Rank, or the edit distance for a fuzzy query,
+    // which returns at most fuzzyLimit) and then by code; without, by code.
+    const vector<ProductNode*>& run(const CatalogQuery& query);
+    // Whether the last run() narrowed the previous result
+    bool lastRunNarrowed() const { return narrowed; }
+    // Heap bytes held by the cached result
+    size_t memoryUsed() const { return results.capacity() * sizeof(ProductNode*) + lastQuery.name.capacity(); }
+    void reset();
+
+private:
+    // A query's facets as sorted taxonomy ids, so products are tested without
+    // touching the dictionaries
+    struct CompiledFilter {
+        vector<uint16_t> categories;
+        vector<uint16_t> subCategories;
+        vector<uint16_t> skinTypes;
+        vector<uint16_t> ranges;
+        bool matchesNothing = false;
+    };
+
+    const ProductBST& products;
+    CatalogQuery lastQuery;
+    vector<ProductNode*> results;
+    size_t revision;
+    bool valid;
+    bool narrowed;
+
+    bool narrows(const CatalogQuery& query, const NameMatcher& matcher) const;
+    static CompiledFilter compile(const ProductFilter& filter);
+    static bool matches(const Product& product, const CompiledFilter& filter);
+};
+
+#endif // CATALOG_SEARCH_H
@@ -0,0 +1,401 @@
+#include "catalog_snapshot.h"
+#include "log.h"
+#include "models.h"
+#include "taxonomy.h"
+#include "trace.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+using namespace std;
+
+namespace {
+
+const char snapshotMagic[8] = {'C', 'C', 'S', 'N', 'A', 'P', 0, 0};
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t productCount;
+    uint64_t dictionaryOffset;
+    uint64_t recordsOffset;
+    uint64_t namesOffset;
+    uint64_t namesSize;
+};
+
+struct SnapshotRecord {
+    int32_t code;
+    int32_t quantity;
+    double price;
+    uint32_t nameOffset;
+    uint32_t nameLength;
+    uint16_t subCategory;
+    uint8_t category;
+    uint8_t skinType;
+    uint8_t range;
+    uint8_t reserved[3];
+    // Since version 2
+    uint32_t imageOffset;
+    uint32_t imageLength;
+};
+
+// Version 1 records stop before the image path
+const uint32_t version1RecordSize = 32;
+
+static_assert(sizeof(SnapshotHeader) == 56, "snapshot header layout changed");
+static_assert(sizeof(SnapshotRecord) == 40, "snapshot record layout changed");
+static_assert(offsetof(SnapshotRecord, imageOffset) == version1RecordSize, "version 1 prefix changed");
+
+template <typename T>
+void appendPod(string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Only the version 1 fields may be read when recordSize is version1RecordSize
+const SnapshotRecord& recordAt(const uchar* records, size_t recordSize, size_t index) {
+    return *reinterpret_cast<const SnapshotRecord*>(records + index * recordSize);
+}
+
+// Smaller text catalogs are parsed on the calling thread alone
+const size_t minChunkBytes = 256 * 1024;
+
+// Parses the products.txt lines in text, skipping blank and malformed ones
+vector<Product> parseTextChunk(string_view text) {
+    TRACE_SPAN("parseTextChunk");
+    vector<Product> parsed;
+    Product product;
+    while (!text.empty()) {
+        size_t end = text.find('\n');
+        string_view line = text.substr(0, end);
+        text.remove_prefix(end == string_view::npos ? text.size() : end + 1);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (line.empty()) continue; // a trailing newline or a blank separator
+        ParseError error = Product::parse(line, product);
+        if (error != ParseError::None) {
+            LOG_WARNING(logCatalog) << "Error deserializing product: " << parseErrorMessage(error);
+            continue;
+        }
+        LOG_VERBOSE(logCatalog) << "Product loaded from file: " << product.code;
+        parsed.push_back(move(product));
+    }
+    return parsed;
+}
+
+}
+
+string CatalogSnapshot::encode(const ProductBST& products) {
+    TRACE_SPAN("CatalogSnapshot::encode");
+    const Taxonomy& taxonomy = Taxonomy::instance();
+    const AttributeDictionary* dictionaries[] = {&taxonomy.categories, &taxonomy.subCategories, &taxonomy.skinTypes, &taxonomy.ranges};
+
+    string dictionary;
+    for (const AttributeDictionary* attribute : dictionaries) {
+        appendPod(dictionary, static_cast<uint32_t>(attribute->size()));
+        for (size_t id = 0; id < attribute->size(); ++id) {
+            const string& value = attribute->name(static_cast<uint16_t>(id));
+            appendPod(dictionary, static_cast<uint16_t>(value.size()));
+            dictionary += value;
+        }
+    }
+    dictionary.resize((dictionary.size() + 7) / 8 * 8, '\0');
+
+    string records;
+    string names;
+    records.reserve(products.size() * sizeof(SnapshotRecord));
+    products.forEachInOrder([&](const Product& product) {
+        SnapshotRecord record = {};
+        record.code = product.code;
+        record.quantity = product.quantity;
+        record.price = product.price;
+        record.nameOffset = static_cast<uint32_t>(names.size());
+        record.nameLength = static_cast<uint32_t>(product.name.size());
+        record.subCategory = product.subCategory;
+        record.category = product.category;
+        record.skinType = product.skinType;
+        record.range = product.range;
+        names += product.name;
+        record.imageOffset = static_cast<uint32_t>(names.size());
+        record.imageLength = static_cast<uint32_t>(product.imagePath.size());
+        names += product.imagePath;
+        appendPod(records, record);
+    });
+
+    SnapshotHeader header = {};
+    memcpy(header.magic, snapshotMagic, sizeof(header.magic));
+    header.version = formatVersion;
+    header.recordSize = sizeof(SnapshotRecord);
+    header.productCount = products.size();
+    header.dictionaryOffset = sizeof(SnapshotHeader);
+    header.recordsOffset = header.dictionaryOffset + dictionary.size();
+    header.namesOffset = header.recordsOffset + records.size();
+    header.namesSize = names.size();
+
+    string out;
+    out.reserve(header.namesOffset + names.size());
+    appendPod(out, header);
+    out += dictionary;
+    out += records;
+    out += names;
+    return out;
+}
+
+bool CatalogSnapshot::isSnapshot(const string& path) {
+    ifstream file(path, ios::binary);
+    char magic[sizeof(snapshotMagic)];
+    return file.read(magic, sizeof(magic)) && memcmp(magic, snapshotMagic, sizeof(magic)) == 0;
+}
+
+CatalogSnapshot::CatalogSnapshot() : data(nullptr), count(0), recordSize(0), records(nullptr), names(nullptr) {}
+
+CatalogSnapshot::~CatalogSnapshot() {
+    close();
+}
+
+void CatalogSnapshot::close() {
+    if (data) {
+        file.unmap(const_cast<uchar*>(data));
+    }
+    file.close();
+    data = nullptr;
+    records = nullptr;
+    names = nullptr;
+    count = 0;
+    recordSize = 0;
+    categoryIds.clear();
+    subCategoryIds.clear();
+    skinTypeIds.clear();
+    rangeIds.clear();
+}
+
+bool CatalogSnapshot::open(const string& path) {
+    close();
+    file.setFileName(QString::fromStdString(path));
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    qint64 length = file.size();
+    if (length < static_cast<qint64>(sizeof(SnapshotHeader))) {
+        close();
+        return false;
+    }
+    data = file.map(0, length);
+    if (!data) {
+        close();
+        return false;
+    }
+
+    SnapshotHeader header;
+    memcpy(&header, data, sizeof(header));
+    uint64_t size = static_cast<uint64_t>(length);
+    bool valid = memcmp(header.magic, snapshotMagic, sizeof(header.magic)) == 0 &&
+                 ((header.version == 1 && header.recordSize == version1RecordSize) ||
+                  (header.version == formatVersion && header.recordSize == sizeof(SnapshotRecord))) &&
+                 header.dictionaryOffset <= header.recordsOffset && header.recordsOffset <= size &&
+                 header.recordsOffset % alignof(SnapshotRecord) == 0 &&
+                 header.productCount <= (size - header.recordsOffset) / header.recordSize &&
+                 header.recordsOffset + header.productCount * header.recordSize <= header.namesOffset &&
+                 header.namesOffset <= size && header.namesSize <= size - header.namesOffset;
+    if (!valid) {
+        LOG_ERROR(logStorage) << "Unsupported or corrupt catalog snapshot " << path;
+        close();
+        return false;
+    }
+
+    // Map the snapshot's dictionary onto this process's taxonomy ids
+    Taxonomy& taxonomy = Taxonomy::instance();
+    AttributeDictionary* dictionaries[] = {&taxonomy.categories, &taxonomy.subCategories, &taxonomy.skinTypes, &taxonomy.ranges};
+    vector<uint16_t>* idMaps[] = {&categoryIds, &subCategoryIds, &skinTypeIds, &rangeIds};
+    const uchar* cursor = data + header.dictionaryOffset;
+    const uchar* end = data + header.recordsOffset;
+    for (int attribute = 0; attribute < 4 && valid; ++attribute) {
+        uint32_t entries;
+        if (end - cursor < static_cast<ptrdiff_t>(sizeof(entries))) {
+            valid = false;
+            break;
+        }
+        memcpy(&entries, cursor, sizeof(entries));
+        cursor += sizeof(entries);
+        for (uint32_t i = 0; i < entries; ++i) {
+            uint16_t nameLength;
+            if (end - cursor < static_cast<ptrdiff_t>(sizeof(nameLength))) {
+                valid = false;
+                break;
+            }
+            memcpy(&nameLength, cursor, sizeof(nameLength));
+            cursor += sizeof(nameLength);
+            if (end - cursor < nameLength) {
+                valid = false;
+                break;
+            }
+            idMaps[attribute]->push_back(dictionaries[attribute]->intern(string_view(reinterpret_cast<const char*>(cursor), nameLength)));
+            cursor += nameLength;
+        }
+    }
+
+    records = data + header.recordsOffset;
+    names = reinterpret_cast<const char*>(data + header.namesOffset);
+    count = header.productCount;
+    recordSize = header.recordSize;
+
+    // Check every record once so the accessors can trust the data
+    for (size_t i = 0; i < count && valid; ++i) {
+        const SnapshotRecord& record = recordAt(records, recordSize, i);
+        valid = static_cast<uint64_t>(record.nameOffset) + record.nameLength <= header.namesSize &&
+                record.category < categoryIds.size() && record.subCategory < subCategoryIds.size() &&
+                record.skinType < skinTypeIds.size() && record.range < rangeIds.size() &&
+                (i == 0 || recordAt(records, recordSize, i - 1).code < record.code);
+        if (valid && hasImages()) {
+            valid = static_cast<uint64_t>(record.imageOffset) + record.imageLength <= header.namesSize;
+        }
+    }
+    if (!valid) {
+        LOG_ERROR(logStorage) << "Corrupt catalog snapshot " << path;
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool CatalogSnapshot::hasImages() const {
+    return recordSize >= sizeof(SnapshotRecord);
+}
+
+int CatalogSnapshot::code(size_t index) const {
+    return recordAt(records, recordSize, index).code;
+}
+
+string_view CatalogSnapshot::name(size_t index) const {
+    const SnapshotRecord& record = recordAt(records, recordSize, index);
+    return string_view(names + record.nameOffset, record.nameLength);
+}
+
+string_view CatalogSnapshot::imagePath(size_t index) const {
+    if (!hasImages()) return string_view();
+    const SnapshotRecord& record = recordAt(records, recordSize, index);
+    return string_view(names + record.imageOffset, record.imageLength);
+}
+
+Product CatalogSnapshot::product(size_t index) const {
+    const SnapshotRecord& record = recordAt(records, recordSize, index);
+    Product product;
+    product.code = record.code;
+    product.name.assign(names + record.nameOffset, record.nameLength);
+    product.imagePath.assign(imagePath(index));
+    product.price = record.price;
+    product.quantity = record.quantity;
+    product.category = static_cast<uint8_t>(categoryIds[record.category]);
+    product.subCategory = subCategoryIds[record.subCategory];
+    product.skinType = static_cast<uint8_t>(skinTypeIds[record.skinType]);
+    product.range = static_cast<uint8_t>(rangeIds[record.range]);
+    return product;
+}
+
+long long CatalogSnapshot::find(int code) const {
+    size_t low = 0;
+    size_t high = count;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        int midCode = recordAt(records, recordSize, mid).code;
+        if (midCode == code) return static_cast<long long>(mid);
+        if (midCode < code) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return -1;
+}
+
+void CatalogSnapshot::loadInto(ProductBST& products) const {
+    TRACE_SPAN("CatalogSnapshot::loadInto");
+    vector<Product> sorted;
+    sorted.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        sorted.push_back(product(i));
+    }
+    products.buildFromSorted(sorted);
+}
+
+// The file is split at line breaks into one chunk per hardware thread; the
+// chunks are parsed concurrently and joined in file order, so a repeated code
+// still resolves to its last record
+bool loadTextCatalog(const string& path, ProductBST& products) {
+    TRACE_SPAN("loadTextCatalog");
+    ifstream file(path, ios::binary);
+    if (!file.is_open()) return false;
+    file.seekg(0, ios::end);
+    string text(static_cast<size_t>(max<streamoff>(file.tellg(), 0)), '\0');
+    file.seekg(0, ios::beg);
+    file.read(&text[0], static_cast<streamsize>(text.size()));
+    text.resize(static_cast<size_t>(file.gcount()));
+    file.close();
+
+    size_t chunkCount = min<size_t>(max(1u, thread::hardware_concurrency()), text.size() / minChunkBytes + 1);
+    vector<string_view> chunks;
+    string_view rest(text);
+    for (size_t i = chunkCount; i > 1 && !rest.empty(); --i) {
+        size_t end = rest.find('\n', rest.size() / i);
+        end = end == string_view::npos ? rest.size() : end + 1;
+        chunks.push_back(rest.substr(0, end));
+        rest.remove_prefix(end);
+    }
+    chunks.push_back(rest);
+
+    vector<vector<Product>> parsed(chunks.size());
+    vector<thread> workers;
+    for (size_t i = 1; i < chunks.size(); ++i) {
+        workers.emplace_back([&, i]() { parsed[i] = parseTextChunk(chunks[i]); });
+    }
+    parsed[0] = parseTextChunk(chunks[0]);
+    for (thread& worker : workers) {
+        worker.join();
+    }
+
+    size_t total = 0;
+    for (const vector<Product>& chunk : parsed) total += chunk.size();
+    vector<Product> loaded = move(parsed[0]);
+    loaded.reserve(total);
+    for (size_t i = 1; i < parsed.size(); ++i) {
+        move(parsed[i].begin(), parsed[i].end(), back_inserter(loaded));
+        vector<Product>().swap(parsed[i]);
+    }
+    products.buildFromSorted(loaded);
+    return true;
+}
+
+bool saveTextCatalog(const string& path, const ProductBST& products) {
+    ofstream file(path);
+    if (!file.is_open()) {
+        LOG_ERROR(logStorage) << "Unable to open " << path << " for writing";
+        return false;
+    }
+    // Written in batches through one reused buffer
+    string buffer;
+    products.forEachInOrder([&](const Product& product) {
+        product.serializeTo(buffer);
+        if (buffer.size() >= 64 * 1024) {
+            file << buffer;
+            buffer.clear();
+        }
+    });
+    file << buffer;
+    file.close();
+    return !file.fail();
+}
+
+bool convertCatalog(const string& inputPath, const string& outputPath) {
+    ProductBST products;
+    if (CatalogSnapshot::isSnapshot(inputPath)) {
+        CatalogSnapshot snapshot;
+        if (!snapshot.open(inputPath)) return false;
+        snapshot.loadInto(products);
+        return saveTextCatalog(outputPath, products);
+    }
+    if (!loadTextCatalog(inputPath, products)) return false;
+    ofstream file(outputPath, ios::binary | ios::trunc);
+    file << CatalogSnapshot::encode(products);
+    file.close();
+    return !file.fail();
+}
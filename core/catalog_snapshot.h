@@ -0,0 +1,76 @@
+#ifndef CATALOG_SNAPSHOT_H
+#define CATALOG_SNAPSHOT_H
+
+#include <QFile>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+class Product;
+class ProductBST;
+
+// Versioned binary snapshot of the product catalog (products.bin).
+//
+// Layout, little-endian:
+//     header      magic "CCSNAP", version, record size, product count and the
+//                 offsets of the sections below
+//     dictionary  category, subCategory, skinType and range names, in id order
+//     records     one fixed-size record per product, sorted by code
+//     names       product names and image paths, referenced by offset and length
+//
+// The file is memory-mapped and read in place: records can be looked up
+// without materializing the catalog, or bulk-loaded into a ProductBST in one
+// pass since they are already sorted. Version 2 added the image path; version
+// 1 snapshots are still read, with no images.
+class CatalogSnapshot {
+public:
+    static const uint32_t formatVersion = 2;
+
+    // Encodes the catalog in the snapshot format
+    static string encode(const ProductBST& products);
+    static bool isSnapshot(const string& path);
+
+    CatalogSnapshot();
+    ~CatalogSnapshot();
+    CatalogSnapshot(const CatalogSnapshot&) = delete;
+    CatalogSnapshot& operator=(const CatalogSnapshot&) = delete;
+
+    // Maps and validates the file; returns false if it is missing or malformed
+    bool open(const string& path);
+    void close();
+
+    size_t size() const { return count; }
+    int code(size_t index) const;
+    string_view name(size_t index) const;
+    string_view imagePath(size_t index) const;
+    Product product(size_t index) const;
+    // Binary search by code; returns -1 when absent
+    long long find(int code) const;
+    void loadInto(ProductBST& products) const;
+
+private:
+    QFile file;
+    const uchar* data;
+    size_t count;
+    size_t recordSize;
+    const uchar* records;
+    const char* names;
+    // Snapshot dictionary id -> Taxonomy id, per attribute
+    vector<uint16_t> categoryIds;
+    vector<uint16_t> subCategoryIds;
+    vector<uint16_t> skinTypeIds;
+    vector<uint16_t> rangeIds;
+
+    bool hasImages() const;
+};
+
+// Text catalog (the products.txt format), kept for import and export
+bool loadTextCatalog(const string& path, ProductBST& products);
+bool saveTextCatalog(const string& path, const ProductBST& products);
+// Converts a snapshot to text or text to a snapshot, depending on the input
+bool convertCatalog(const string& inputPath, const string& outputPath);
+
+#endif // CATALOG_SNAPSHOT_H
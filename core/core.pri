@@ -0,0 +1,13 @@
+# Include from a project one directory below the top level to build against
+# the core library.
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+QT *= core
+
+win32:CONFIG(release, debug|release): CORE_LIB_DIR = $$OUT_PWD/../core/release
+else:win32:CONFIG(debug, debug|release): CORE_LIB_DIR = $$OUT_PWD/../core/debug
+else: CORE_LIB_DIR = $$OUT_PWD/../core
+
+LIBS += -L$$CORE_LIB_DIR -lcore
+win32:!win32-g++: PRE_TARGETDEPS += $$CORE_LIB_DIR/core.lib
+else: PRE_TARGETDEPS += $$CORE_LIB_DIR/libcore.a
@@ -0,0 +1,47 @@
+# The catalog engine: domain model, indexes and storage. Uses QtCore only
+# (QObject signals, QFile mapping), never QtGui or QtWidgets, so it can be
+# linked into headless tools, benchmarks and services through core.pri.
+TEMPLATE = lib
+TARGET = core
+CONFIG += staticlib c++17
+QT = core
+
+# Run qmake with CONFIG+=fuzzy_avx2 to verify fuzzy search candidates four at a
+# time with AVX2 (see fuzzy_match.h).
+fuzzy_avx2 {
+    DEFINES += FUZZY_AVX2
+    QMAKE_CXXFLAGS += -mavx2
+}
+
+# CONFIG+=no_metrics compiles the latency timers out (see metrics.h)
+no_metrics: DEFINES += CATALOG_NO_METRICS
+
+SOURCES += \
+    catalog_log.cpp \
+    catalog_search.cpp \
+    catalog_snapshot.cpp \
+    fuzzy_match.cpp \
+    log.cpp \
+    metrics.cpp \
+    models.cpp \
+    name_index.cpp \
+    order_log.cpp \
+    persistence_service.cpp \
+    product_index.cpp \
+    taxonomy.cpp \
+    trace.cpp
+
+HEADERS += \
+    catalog_log.h \
+    catalog_search.h \
+    catalog_snapshot.h \
+    fuzzy_match.h \
+    log.h \
+    metrics.h \
+    models.h \
+    name_index.h \
+    order_log.h \
+    persistence_service.h \
+    product_index.h \
+    taxonomy.h \
+    trace.h
@@ -0,0 +1,248 @@
+#include "fuzzy_match.h"
+#include "name_index.h"
+#include <algorithm>
+#include <cstring>
+#if defined(FUZZY_AVX2) && defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+int lengthGap(size_t a, size_t b) {
+    return static_cast<int>(a > b ? a - b : b - a);
+}
+
+}
+
+// FuzzyMatcher implementation
+FuzzyMatcher::FuzzyMatcher(string_view query) : pattern(query), lastBit(0) {
+    memset(peq, 0, sizeof(peq));
+    if (pattern.empty() || pattern.size() > 64) return;
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        peq[static_cast<unsigned char>(pattern[i])] |= uint64_t(1) << i;
+    }
+    lastBit = uint64_t(1) << (pattern.size() - 1);
+}
+
+int FuzzyMatcher::distance(string_view text, int bound) const {
+    size_t m = pattern.size();
+    if (lengthGap(m, text.size()) > bound) return bound + 1;
+    if (m == 0) return static_cast<int>(text.size());
+    if (m > 64) return dynamicDistance(text, bound);
+
+    // Column j of the DP table is score (its last cell) plus the vertical
+    // deltas Pv/Mv (+1/-1 between consecutive rows). The top row counts
+    // j, which is why a 1 is shifted into Ph: a global, not a search, match.
+    uint64_t pv = m == 64 ? ~uint64_t(0) : (uint64_t(1) << m) - 1;
+    uint64_t mv = 0;
+    int score = static_cast<int>(m);
+    for (size_t j = 0; j < text.size(); ++j) {
+        uint64_t eq = peq[static_cast<unsigned char>(text[j])];
+        uint64_t xv = eq | mv;
+        uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        uint64_t ph = mv | ~(xh | pv);
+        uint64_t mh = pv & xh;
+        if (ph & lastBit) {
+            ++score;
+        } else if (mh & lastBit) {
+            --score;
+        }
+        ph = (ph << 1) | 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+        // The score drops by at most one per remaining character
+        if (score - static_cast<int>(text.size() - j - 1) > bound) return bound + 1;
+    }
+    return score <= bound ? score : bound + 1;
+}
+
+int FuzzyMatcher::dynamicDistance(string_view text, int bound) const {
+    vector<int> row(text.size() + 1);
+    for (size_t j = 0; j <= text.size(); ++j) row[j] = static_cast<int>(j);
+    for (size_t i = 1; i <= pattern.size(); ++i) {
+        int diagonal = row[0];
+        row[0] = static_cast<int>(i);
+        int best = row[0];
+        for (size_t j = 1; j <= text.size(); ++j) {
+            int above = row[j];
+            row[j] = min({above + 1, row[j - 1] + 1, diagonal + (pattern[i - 1] == text[j - 1] ? 0 : 1)});
+            diagonal = above;
+            best = min(best, row[j]);
+        }
+        if (best > bound) return bound + 1;
+    }
+    return row.back() <= bound ? row.back() : bound + 1;
+}
+
+#if defined(FUZZY_AVX2) && defined(__AVX2__)
+// The same recurrence as distance(), one text per 64-bit lane. Lanes whose
+// text has ended keep stepping but no longer change their score.
+void FuzzyMatcher::distance4(const string_view texts[4], int bound, int out[4]) const {
+    size_t m = pattern.size();
+    if (m == 0 || m > 64) {
+        for (int lane = 0; lane < 4; ++lane) out[lane] = distance(texts[lane], bound);
+        return;
+    }
+    size_t longest = 0;
+    for (int lane = 0; lane < 4; ++lane) longest = max(longest, texts[lane].size());
+
+    const __m256i allOnes = _mm256_set1_epi64x(-1);
+    const __m256i one = _mm256_set1_epi64x(1);
+    const __m256i last = _mm256_set1_epi64x(static_cast<long long>(lastBit));
+    __m256i pv = _mm256_set1_epi64x(static_cast<long long>(m == 64 ? ~uint64_t(0) : (uint64_t(1) << m) - 1));
+    __m256i mv = _mm256_setzero_si256();
+    __m256i score = _mm256_set1_epi64x(static_cast<long long>(m));
+    for (size_t j = 0; j < longest; ++j) {
+        long long eqs[4];
+        long long active[4];
+        for (int lane = 0; lane < 4; ++lane) {
+            bool inside = j < texts[lane].size();
+            eqs[lane] = inside ? static_cast<long long>(peq[static_cast<unsigned char>(texts[lane][j])]) : 0;
+            active[lane] = inside ? -1 : 0;
+        }
+        __m256i eq = _mm256_set_epi64x(eqs[3], eqs[2], eqs[1], eqs[0]);
+        __m256i live = _mm256_set_epi64x(active[3], active[2], active[1], active[0]);
+        __m256i xv = _mm256_or_si256(eq, mv);
+        __m256i xh = _mm256_or_si256(_mm256_xor_si256(_mm256_add_epi64(_mm256_and_si256(eq, pv), pv), pv), eq);
+        __m256i ph = _mm256_or_si256(mv, _mm256_andnot_si256(_mm256_or_si256(xh, pv), allOnes));
+        __m256i mh = _mm256_and_si256(pv, xh);
+        // All ones (-1) in lanes whose last row went up or down
+        __m256i up = _mm256_cmpeq_epi64(_mm256_and_si256(ph, last), last);
+        __m256i down = _mm256_andnot_si256(up, _mm256_cmpeq_epi64(_mm256_and_si256(mh, last), last));
+        score = _mm256_sub_epi64(score, _mm256_and_si256(up, live));
+        score = _mm256_add_epi64(score, _mm256_and_si256(down, live));
+        ph = _mm256_or_si256(_mm256_slli_epi64(ph, 1), one);
+        mh = _mm256_slli_epi64(mh, 1);
+        pv = _mm256_or_si256(mh, _mm256_andnot_si256(_mm256_or_si256(xv, ph), allOnes));
+        mv = _mm256_and_si256(ph, xv);
+    }
+
+    long long scores[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(scores), score);
+    for (int lane = 0; lane < 4; ++lane) {
+        out[lane] = scores[lane] <= bound ? static_cast<int>(scores[lane]) : bound + 1;
+    }
+}
+#else
+void FuzzyMatcher::distance4(const string_view texts[4], int bound, int out[4]) const {
+    for (int lane = 0; lane < 4; ++lane) out[lane] = distance(texts[lane], bound);
+}
+#endif
+
+vector<FuzzyHit> fuzzySearch(const TrigramIndex& index, size_t slotCount, const function<const string*(uint32_t)>& nameOf,
+                             string_view query, int maxDistance, size_t limit, const function<bool(uint32_t, uint32_t)>& before) {
+    vector<FuzzyHit> best;
+    string normalized = normalizeName(query);
+    if (normalized.empty() || maxDistance < 0 || limit == 0) return best;
+    FuzzyMatcher matcher(normalized);
+    size_t queryWords = count(normalized.begin(), normalized.end(), ' ') + 1;
+
+    vector<uint32_t> trigrams;
+    TrigramIndex::wordTrigrams(normalized, trigrams);
+    long long minShared = static_cast<long long>(trigrams.size()) - 3LL * maxDistance;
+    vector<uint32_t> candidates;
+    if (minShared >= 1) {
+        index.slotsSharing(trigrams, static_cast<size_t>(minShared), candidates);
+    } else {
+        // Too few trigrams to filter on; every slot is a candidate
+        candidates.resize(slotCount);
+        for (size_t slot = 0; slot < slotCount; ++slot) candidates[slot] = static_cast<uint32_t>(slot);
+    }
+
+    // best is a max-heap of the closest hits so far. Candidates come in slot
+    // order, so with ties broken by slot, once it is full a later slot has to
+    // be strictly closer than its worst hit to get in, and the bound tightens
+    // accordingly. Another tie-break can still let a later slot in at the
+    // worst hit's distance.
+    auto closer = [&](const FuzzyHit& a, const FuzzyHit& b) {
+        if (a.distance != b.distance) return a.distance < b.distance;
+        return before ? before(a.slot, b.slot) : a.slot < b.slot;
+    };
+    int bound = maxDistance;
+    auto offer = [&](uint32_t slot, int distance) {
+        if (distance > bound) return;
+        FuzzyHit hit = {slot, distance};
+        if (best.size() == limit) {
+            if (!closer(hit, best.front())) return;
+            pop_heap(best.begin(), best.end(), closer);
+            best.pop_back();
+        }
+        best.push_back(hit);
+        push_heap(best.begin(), best.end(), closer);
+        if (best.size() == limit) bound = before ? best.front().distance : best.front().distance - 1;
+    };
+
+    // Windows are verified in batches so distance4 always has four to run
+    struct Window {
+        uint32_t slot;
+        size_t offset;
+        size_t length;
+    };
+    string arena;
+    vector<Window> windows;
+    vector<int> distances;
+    auto verify = [&]() {
+        distances.resize(windows.size());
+        for (size_t i = 0; i < windows.size(); i += 4) {
+            string_view texts[4];
+            int results[4];
+            for (size_t lane = 0; lane < 4 && i + lane < windows.size(); ++lane) {
+                texts[lane] = string_view(arena).substr(windows[i + lane].offset, windows[i + lane].length);
+            }
+            matcher.distance4(texts, bound, results);
+            for (size_t lane = 0; lane < 4 && i + lane < windows.size(); ++lane) {
+                distances[i + lane] = results[lane];
+            }
+        }
+        // A slot's windows are adjacent; only its closest one counts
+        for (size_t i = 0; i < windows.size();) {
+            uint32_t slot = windows[i].slot;
+            int distance = distances[i];
+            for (++i; i < windows.size() && windows[i].slot == slot; ++i) distance = min(distance, distances[i]);
+            offer(slot, distance);
+        }
+        windows.clear();
+        arena.clear();
+    };
+
+    string name;
+    vector<size_t> starts;
+    vector<size_t> ends;
+    for (uint32_t slot : candidates) {
+        if (bound < 0) break;
+        const string* raw = nameOf(slot);
+        if (!raw) continue;
+        normalizeNameTo(*raw, name);
+        starts.clear();
+        ends.clear();
+        for (size_t at = 0; at < name.size();) {
+            size_t end = name.find(' ', at);
+            if (end == string::npos) end = name.size();
+            starts.push_back(at);
+            ends.push_back(end);
+            at = end + 1;
+        }
+        size_t nameOffset = arena.size();
+        bool added = false;
+        size_t fewest = max<size_t>(queryWords, 2) - 1;
+        for (size_t words = fewest; words <= queryWords + 1 && words <= starts.size(); ++words) {
+            for (size_t first = 0; first + words <= starts.size(); ++first) {
+                size_t length = ends[first + words - 1] - starts[first];
+                if (lengthGap(length, normalized.size()) > bound) continue;
+                if (!added) {
+                    arena += name;
+                    added = true;
+                }
+                windows.push_back({slot, nameOffset + starts[first], length});
+            }
+        }
+        if (windows.size() >= 64) verify();
+    }
+    verify();
+
+    sort(best.begin(), best.end(), closer);
+    return best;
+}
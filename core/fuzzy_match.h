@@ -0,0 +1,60 @@
+#ifndef FUZZY_MATCH_H
+#define FUZZY_MATCH_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+class TrigramIndex;
+
+// Levenshtein distance from one query to many texts, using Myers' bit-vector
+// algorithm in Hyyrö's formulation: the query's edit-distance column is kept
+// as vertical delta bit vectors and advanced one text character per step.
+// Queries up to 64 characters fit in one machine word; longer ones fall back
+// to the row-by-row dynamic program.
+class FuzzyMatcher {
+public:
+    explicit FuzzyMatcher(string_view query);
+
+    const string& query() const { return pattern; }
+    // The edit distance, or bound + 1 once it is certain to exceed bound
+    int distance(string_view text, int bound) const;
+    // distance() for four texts at once. Built with FUZZY_AVX2 on a compiler
+    // targeting AVX2, the four run in the lanes of one vector register.
+    void distance4(const string_view texts[4], int bound, int out[4]) const;
+
+private:
+    string pattern;
+    uint64_t peq[256]; // bit i set where pattern[i] is the character
+    uint64_t lastBit;
+
+    int dynamicDistance(string_view text, int bound) const;
+};
+
+struct FuzzyHit {
+    uint32_t slot;
+    int distance;
+};
+
+// Finds up to limit names within maxDistance edits of query, closest first.
+// Names are compared normalized (see normalizeName), and a query of n words
+// is measured against every run of n - 1 to n + 1 consecutive words of a
+// name, so "clenser" finds "Gentle Cleanser Gel" at distance 1.
+// Candidates pass two filters before being verified:
+//   - q-gram: each edit destroys at most three of the query's padded
+//     trigrams, so a match shares at least (trigrams - 3 * maxDistance) of
+//     them; the index supplies the slots that do
+//   - length: a window whose length differs from the query's by more than
+//     the current bound can't be close enough
+// nameOf returns the name in a slot, or nullptr to skip the slot. Hits at
+// the same distance are ranked by before(a, b), or by slot when it is null,
+// which also decides the ties cut off at limit.
+vector<FuzzyHit> fuzzySearch(const TrigramIndex& index, size_t slotCount, const function<const string*(uint32_t)>& nameOf,
+                             string_view query, int maxDistance, size_t limit,
+                             const function<bool(uint32_t, uint32_t)>& before = nullptr);
+
+#endif // FUZZY_MATCH_H
@@ -0,0 +1,148 @@
+#include "log.h"
+#include "trace.h"
+#include <QDateTime>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+namespace {
+
+const char* const levelNames[] = {"verbose", "debug", "info", "warning", "error", "off"};
+const char levelLetters[] = {'V', 'D', 'I', 'W', 'E'};
+
+// The threshold DSA1_LOG sets for a category, or info
+LogLevel configuredThreshold(const char* category) {
+    LogLevel threshold = LogLevel::Info;
+    const char* config = getenv("DSA1_LOG");
+    if (!config) return threshold;
+    string entries(config);
+    size_t at = 0;
+    while (at <= entries.size()) {
+        size_t end = entries.find(',', at);
+        if (end == string::npos) end = entries.size();
+        string entry = entries.substr(at, end - at);
+        at = end + 1;
+        string levelName = entry;
+        size_t equals = entry.find('=');
+        if (equals != string::npos) {
+            if (entry.compare(0, equals, category) != 0) continue;
+            levelName = entry.substr(equals + 1);
+        }
+        for (int level = 0; level <= static_cast<int>(LogLevel::Off); ++level) {
+            if (levelName == levelNames[level]) threshold = static_cast<LogLevel>(level);
+        }
+    }
+    return threshold;
+}
+
+// Writes queued lines to stderr on its own thread
+class LogSink {
+public:
+    static constexpr size_t capacity = 8192;
+
+    LogSink() : dropped(0), busy(false), closed(false), writer([this] { run(); }) {}
+
+    void submit(string line) {
+        unique_lock<mutex> guard(lock);
+        if (closed) {
+            // Past shutdown there is no writer left; write in place
+            guard.unlock();
+            fputs(line.c_str(), stderr);
+            return;
+        }
+        if (lines.size() >= capacity) {
+            ++dropped;
+            return;
+        }
+        lines.push_back(move(line));
+        guard.unlock();
+        queued.notify_one();
+    }
+
+    void flush() {
+        unique_lock<mutex> guard(lock);
+        drained.wait(guard, [this] { return closed || (lines.empty() && !busy); });
+    }
+
+    // Writes what is queued and stops the writer
+    void close() {
+        {
+            lock_guard<mutex> guard(lock);
+            if (closed) return;
+            closed = true;
+        }
+        queued.notify_one();
+        writer.join();
+    }
+
+private:
+    mutex lock;
+    condition_variable queued;
+    condition_variable drained;
+    deque<string> lines;
+    size_t dropped;
+    bool busy;
+    bool closed;
+    thread writer;
+
+    void run() {
+        Trace::setThreadName("Log writer");
+        unique_lock<mutex> guard(lock);
+        while (true) {
+            queued.wait(guard, [this] { return closed || !lines.empty(); });
+            if (lines.empty() && closed) break;
+            deque<string> batch;
+            batch.swap(lines);
+            size_t lost = dropped;
+            dropped = 0;
+            busy = true;
+            guard.unlock();
+            for (const string& line : batch) fputs(line.c_str(), stderr);
+            if (lost) fprintf(stderr, "%zu log messages dropped\n", lost);
+            fflush(stderr);
+            guard.lock();
+            busy = false;
+            drained.notify_all();
+        }
+        drained.notify_all();
+    }
+};
+
+LogSink& sink() {
+    static LogSink* instance = new LogSink;
+    // Drains the queue at exit; the sink itself is never destroyed, so lines
+    // logged later are still written
+    static struct Closer {
+        ~Closer() { instance->close(); }
+    } closer;
+    return *instance;
+}
+
+}
+
+LogCategory logUsers("users");
+LogCategory logCatalog("catalog");
+LogCategory logOrders("orders");
+LogCategory logStorage("storage");
+
+LogCategory::LogCategory(const char* name) : categoryName(name), threshold(static_cast<int>(configuredThreshold(name))) {}
+
+LogMessage::LogMessage(const LogCategory& category, LogLevel level) {
+    text << QTime::currentTime().toString("hh:mm:ss.zzz").toStdString() << ' ' << levelLetters[static_cast<int>(level)] << ' '
+         << category.name() << ": ";
+}
+
+LogMessage::~LogMessage() {
+    text << '\n';
+    sink().submit(text.str());
+}
+
+void flushLog() {
+    sink().flush();
+}
@@ -0,0 +1,84 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <atomic>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+// Leveled, categorized logging. A message is only formatted when its
+// category is enabled at its level: the macros below skip the whole
+// statement, arguments included, otherwise. LOG_VERBOSE, meant for per-record
+// messages, compiles to nothing in release builds. Formatted lines go to
+// stderr from a background thread, so logging never waits on the terminal;
+// if the thread falls too far behind, lines are dropped and counted.
+//
+// Thresholds come from the DSA1_LOG environment variable, a comma-separated
+// list of "level" (every category) and "category=level" entries, e.g.
+//     DSA1_LOG=warning,catalog=verbose
+// Levels are verbose, debug, info, warning, error and off; the default is info.
+enum class LogLevel { Verbose, Debug, Info, Warning, Error, Off };
+
+class LogCategory {
+public:
+    // name must outlive the category, e.g. a string literal
+    explicit LogCategory(const char* name);
+    LogCategory(const LogCategory&) = delete;
+    LogCategory& operator=(const LogCategory&) = delete;
+
+    const char* name() const { return categoryName; }
+    bool isEnabled(LogLevel level) const { return static_cast<int>(level) >= threshold.load(memory_order_relaxed); }
+    void setThreshold(LogLevel level) { threshold.store(static_cast<int>(level), memory_order_relaxed); }
+
+private:
+    const char* categoryName;
+    atomic<int> threshold;
+};
+
+// The core library's categories
+extern LogCategory logUsers;
+extern LogCategory logCatalog;
+extern LogCategory logOrders;
+extern LogCategory logStorage;
+
+// One line being built; it is queued for output when destroyed
+class LogMessage {
+public:
+    LogMessage(const LogCategory& category, LogLevel level);
+    ~LogMessage();
+    LogMessage(const LogMessage&) = delete;
+    LogMessage& operator=(const LogMessage&) = delete;
+
+    template <typename T>
+    LogMessage& operator<<(const T& value) {
+        text << value;
+        return *this;
+    }
+
+private:
+    ostringstream text;
+};
+
+// Waits until every line logged so far has been written
+void flushLog();
+
+#define LOG_AT(category, level) \
+    if (!(category).isEnabled(level)) { \
+    } else \
+        LogMessage(category, level)
+
+#ifdef QT_NO_DEBUG
+#define LOG_VERBOSE(category) \
+    if (true) { \
+    } else \
+        LogMessage(category, LogLevel::Verbose)
+#else
+#define LOG_VERBOSE(category) LOG_AT(category, LogLevel::Verbose)
+#endif
+#define LOG_DEBUG(category) LOG_AT(category, LogLevel::Debug)
+#define LOG_INFO(category) LOG_AT(category, LogLevel::Info)
+#define LOG_WARNING(category) LOG_AT(category, LogLevel::Warning)
+#define LOG_ERROR(category) LOG_AT(category, LogLevel::Error)
+
+#endif // LOG_H
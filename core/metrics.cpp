@@ -0,0 +1,124 @@
+#include "metrics.h"
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <mutex>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+using namespace std;
+
+static int highestBit(uint64_t value) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return static_cast<int>(index);
+#else
+    return 63 - __builtin_clzll(value);
+#endif
+}
+
+// LatencyHistogram implementation
+LatencyHistogram::LatencyHistogram(const string& name)
+    : histogramName(name), buckets(new atomic<uint64_t>[bucketCount]), sum(0), maximum(0) {
+    for (size_t i = 0; i < bucketCount; ++i) buckets[i].store(0, memory_order_relaxed);
+}
+
+// Values below 2^(subBucketBits + 1) get a bucket each; above that, a value
+// with its highest bit at magnitude m falls in one of the 32 buckets of
+// [2^m, 2^(m+1)), chosen by the 5 bits below the highest
+size_t LatencyHistogram::bucketOf(uint64_t value) {
+    const uint64_t linearLimit = uint64_t(1) << (subBucketBits + 1);
+    if (value < linearLimit) return static_cast<size_t>(value);
+    int magnitude = highestBit(value);
+    if (magnitude > maxMagnitude) return bucketCount - 1;
+    int shift = magnitude - subBucketBits;
+    return (static_cast<size_t>(shift) << subBucketBits) + static_cast<size_t>(value >> shift);
+}
+
+uint64_t LatencyHistogram::highestValueIn(size_t bucket) {
+    const size_t linearLimit = size_t(1) << (subBucketBits + 1);
+    if (bucket < linearLimit) return bucket;
+    size_t shift = (bucket >> subBucketBits) - 1;
+    uint64_t subBucket = (bucket & ((size_t(1) << subBucketBits) - 1)) + (uint64_t(1) << subBucketBits);
+    return ((subBucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t nanoseconds) {
+    buckets[bucketOf(nanoseconds)].fetch_add(1, memory_order_relaxed);
+    sum.fetch_add(nanoseconds, memory_order_relaxed);
+    uint64_t seen = maximum.load(memory_order_relaxed);
+    while (nanoseconds > seen && !maximum.compare_exchange_weak(seen, nanoseconds, memory_order_relaxed)) {
+    }
+}
+
+// Summed from the buckets so recording touches one counter less
+uint64_t LatencyHistogram::count() const {
+    uint64_t recorded = 0;
+    for (size_t i = 0; i < bucketCount; ++i) recorded += buckets[i].load(memory_order_relaxed);
+    return recorded;
+}
+
+double LatencyHistogram::mean() const {
+    uint64_t recorded = count();
+    return recorded ? static_cast<double>(sum.load(memory_order_relaxed)) / recorded : 0.0;
+}
+
+uint64_t LatencyHistogram::percentile(double fraction) const {
+    uint64_t recorded = count();
+    if (recorded == 0) return 0;
+    fraction = clamp(fraction, 0.0, 1.0);
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(fraction * recorded + 0.5));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < bucketCount; ++i) {
+        seen += buckets[i].load(memory_order_relaxed);
+        if (seen >= rank) return min(highestValueIn(i), max());
+    }
+    return max();
+}
+
+void LatencyHistogram::reset() {
+    for (size_t i = 0; i < bucketCount; ++i) buckets[i].store(0, memory_order_relaxed);
+    sum.store(0, memory_order_relaxed);
+    maximum.store(0, memory_order_relaxed);
+}
+
+// Metrics implementation
+namespace {
+
+struct Registry {
+    mutex lock;
+    map<string, LatencyHistogram*> byName;
+    deque<LatencyHistogram> histograms; // never moves its elements
+};
+
+Registry& registry() {
+    static Registry* instance = new Registry; // left alive for timers that run during exit
+    return *instance;
+}
+
+}
+
+LatencyHistogram& Metrics::histogram(const string& name) {
+    Registry& r = registry();
+    lock_guard<mutex> guard(r.lock);
+    auto it = r.byName.find(name);
+    if (it != r.byName.end()) return *it->second;
+    r.histograms.emplace_back(name);
+    r.byName.emplace(name, &r.histograms.back());
+    return r.histograms.back();
+}
+
+vector<LatencyHistogram*> Metrics::histograms() {
+    Registry& r = registry();
+    lock_guard<mutex> guard(r.lock);
+    vector<LatencyHistogram*> all;
+    all.reserve(r.byName.size());
+    for (const auto& entry : r.byName) all.push_back(entry.second);
+    return all;
+}
+
+void Metrics::resetAll() {
+    for (LatencyHistogram* histogram : histograms()) histogram->reset();
+}
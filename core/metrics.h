@@ -0,0 +1,103 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "trace.h"
+
+using namespace std;
+
+// Latency histogram with HDR-style log-linear buckets: every power of two is
+// split into 32 equal buckets, so a percentile is within about 3% of the
+// recorded value from 1 ns up to about 18 minutes (longer values land in the
+// last bucket). Recording is lock-free and safe from any thread.
+class LatencyHistogram {
+public:
+    explicit LatencyHistogram(const string& name);
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    const string& name() const { return histogramName; }
+    void record(uint64_t nanoseconds);
+    uint64_t count() const;
+    uint64_t max() const { return maximum.load(memory_order_relaxed); }
+    double mean() const;
+    // The value below which fraction (0 to 1) of the recordings fall, to
+    // bucket precision; 0 when nothing was recorded
+    uint64_t percentile(double fraction) const;
+    void reset();
+
+    static constexpr int subBucketBits = 5;
+    static constexpr int maxMagnitude = 40;
+    static constexpr size_t bucketCount = (maxMagnitude - subBucketBits + 2) << subBucketBits;
+
+private:
+    string histogramName;
+    unique_ptr<atomic<uint64_t>[]> buckets;
+    atomic<uint64_t> sum;
+    atomic<uint64_t> maximum;
+
+    static size_t bucketOf(uint64_t value);
+    static uint64_t highestValueIn(size_t bucket);
+};
+
+// Records the time until it goes out of scope, and a trace span of the same
+// name while tracing is on
+class ScopedTimer {
+public:
+    explicit ScopedTimer(LatencyHistogram& histogram) : histogram(histogram), start(chrono::steady_clock::now()) {}
+    ~ScopedTimer() {
+        chrono::steady_clock::time_point end = chrono::steady_clock::now();
+        histogram.record(static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(end - start).count()));
+        if (Trace::enabled()) {
+            Trace::record(histogram.name().c_str(), nanosecondsOf(start), nanosecondsOf(end));
+        }
+    }
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    LatencyHistogram& histogram;
+    chrono::steady_clock::time_point start;
+
+    static int64_t nanosecondsOf(chrono::steady_clock::time_point time) {
+        return chrono::duration_cast<chrono::nanoseconds>(time.time_since_epoch()).count();
+    }
+};
+
+// Process-wide registry of named histograms. Histograms live until exit, so
+// call sites can keep a reference.
+class Metrics {
+public:
+    // Creates the histogram the first time name is asked for
+    static LatencyHistogram& histogram(const string& name);
+    // Every histogram, ordered by name
+    static vector<LatencyHistogram*> histograms();
+    static void resetAll();
+};
+
+// Times the rest of the enclosing scope into the histogram called name. The
+// histogram is looked up once per call site. A timer costs two clock reads
+// and two atomic adds; building with CONFIG+=no_metrics removes them all,
+// along with the trace spans they record.
+#ifdef CATALOG_NO_METRICS
+#define SCOPED_LATENCY(name) ((void)0)
+#else
+#define SCOPED_LATENCY(name) \
+    static LatencyHistogram& scopedLatencyHistogram = Metrics::histogram(name); \
+    ScopedTimer scopedLatencyTimer(scopedLatencyHistogram)
+#endif
+
+// Heap memory a string owns; 0 while it fits the small-string buffer
+inline size_t stringHeapBytes(const string& text) {
+    const char* data = text.data();
+    const char* object = reinterpret_cast<const char*>(&text);
+    if (data >= object && data < object + sizeof(string)) return 0;
+    return text.capacity() + 1;
+}
+
+#endif // METRICS_H
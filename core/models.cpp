@@ -0,0 +1,656 @@
+#include "models.h"
+#include "log.h"
+#include "metrics.h"
+#include "taxonomy.h"
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+
+using namespace std;
+
+// Parsing helpers shared by User, Product and Order
+const char* parseErrorMessage(ParseError error) {
+    switch (error) {
+    case ParseError::None: return "No error";
+    case ParseError::MissingField: return "Missing field";
+    case ParseError::BadNumber: return "Malformed number";
+    case ParseError::EmptyRecord: return "Empty record";
+    }
+    return "Unknown error";
+}
+
+// Splits the next delimiter-terminated field off the front of text
+static bool nextField(string_view& text, string_view& field) {
+    size_t comma = text.find(',');
+    if (comma == string_view::npos) return false;
+    field = text.substr(0, comma);
+    text.remove_prefix(comma + 1);
+    return true;
+}
+
+static string_view trimLineEnd(string_view text) {
+    while (!text.empty() && (text.back() == '\n' || text.back() == '\r')) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+template <typename T>
+static bool parseNumberAs(string_view text, T& value) {
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\r' || text.back() == '\n')) text.remove_suffix(1);
+    while (!text.empty() && text.front() == ' ') text.remove_prefix(1);
+    if (!text.empty() && text.front() == '+') text.remove_prefix(1);
+    auto result = from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == errc() && result.ptr == text.data() + text.size();
+}
+
+bool parseNumber(string_view text, int& value) {
+    return parseNumberAs(text, value);
+}
+
+bool parseNumber(string_view text, long long& value) {
+    return parseNumberAs(text, value);
+}
+
+bool parseNumber(string_view text, double& value) {
+    return parseNumberAs(text, value);
+}
+
+static void appendInt(string& out, long long value) {
+    char buffer[24];
+    auto result = to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+// Heap memory held by a product's strings, for the memoryUsed() estimates
+static size_t productHeapBytes(const Product& product) {
+    return stringHeapBytes(product.name) + stringHeapBytes(product.imagePath);
+}
+
+// User class implementation
+User::User() : username(""), password(""), isStaff(false) {}
+
+User::User(const string& u, const string& p, bool s) : username(u), password(p), isStaff(s) {}
+
+string User::serialize() const {
+    string out;
+    serializeTo(out);
+    return out;
+}
+
+void User::serializeTo(string& out) const {
+    out += username;
+    out += ',';
+    out += password;
+    out += isStaff ? ",1\n" : ",0\n";
+}
+
+User User::deserialize(const string& str) {
+    User user;
+    if (parse(str, user) != ParseError::None) {
+        throw invalid_argument("Malformed input string for User deserialization");
+    }
+    return user;
+}
+
+ParseError User::parse(string_view text, User& user) {
+    if (trimLineEnd(text).empty()) return ParseError::EmptyRecord;
+    string_view username;
+    string_view password;
+    if (!nextField(text, username) || !nextField(text, password) || text.empty()) {
+        return ParseError::MissingField;
+    }
+    user.username.assign(username);
+    user.password.assign(password);
+    user.isStaff = text[0] == '1';
+    return ParseError::None;
+}
+
+// UserList implementation
+UserList::UserList() : hashes(16, 0), entries(16), count(0) {}
+
+uint64_t UserList::hashOf(const string& username) {
+    // Finalize std::hash so low bits are usable as a bucket index
+    uint64_t h = hash<string>()(username);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h ? h : 1;
+}
+
+bool UserList::addUser(const User& user) {
+    if ((count + 1) * 10 > hashes.size() * 7) {
+        grow();
+    }
+    uint64_t h = hashOf(user.username);
+    size_t mask = hashes.size() - 1;
+    size_t i = h & mask;
+    while (hashes[i]) {
+        if (hashes[i] == h && entries[i].username == user.username) {
+            return false;
+        }
+        i = (i + 1) & mask;
+    }
+    hashes[i] = h;
+    entries[i] = user;
+    ++count;
+    return true;
+}
+
+User* UserList::findUser(const string& username) {
+    uint64_t h = hashOf(username);
+    size_t mask = hashes.size() - 1;
+    for (size_t i = h & mask; hashes[i]; i = (i + 1) & mask) {
+        if (hashes[i] == h && entries[i].username == username) {
+            return &entries[i];
+        }
+    }
+    return nullptr;
+}
+
+void UserList::grow() {
+    vector<uint64_t> oldHashes;
+    vector<User> oldEntries;
+    oldHashes.swap(hashes);
+    oldEntries.swap(entries);
+    hashes.assign(oldHashes.size() * 2, 0);
+    entries.resize(oldEntries.size() * 2);
+    size_t mask = hashes.size() - 1;
+    for (size_t j = 0; j < oldHashes.size(); ++j) {
+        if (!oldHashes[j]) continue;
+        size_t i = oldHashes[j] & mask;
+        while (hashes[i]) {
+            i = (i + 1) & mask;
+        }
+        hashes[i] = oldHashes[j];
+        entries[i] = move(oldEntries[j]);
+    }
+}
+
+UserList::Stats UserList::stats() const {
+    Stats stats;
+    stats.size = count;
+    stats.capacity = hashes.size();
+    stats.loadFactor = static_cast<double>(count) / hashes.size();
+    stats.maxProbeLength = 0;
+    size_t totalProbes = 0;
+    size_t mask = hashes.size() - 1;
+    for (size_t i = 0; i < hashes.size(); ++i) {
+        if (!hashes[i]) continue;
+        // Probes needed to find this user: distance from its home bucket, plus one
+        size_t probes = ((i - (hashes[i] & mask)) & mask) + 1;
+        totalProbes += probes;
+        stats.maxProbeLength = max(stats.maxProbeLength, probes);
+    }
+    stats.averageProbeLength = count ? static_cast<double>(totalProbes) / count : 0.0;
+    return stats;
+}
+
+size_t UserList::memoryUsed() const {
+    size_t bytes = sizeof(UserList) + hashes.capacity() * sizeof(uint64_t) + entries.capacity() * sizeof(User);
+    for (const User& user : entries) {
+        bytes += stringHeapBytes(user.username) + stringHeapBytes(user.password);
+    }
+    return bytes;
+}
+
+// Product class implementation
+Product::Product() : code(0), name(""), imagePath(""), price(0.0), quantity(0), subCategory(0), category(0), skinType(0), range(0) {}
+
+Product::Product(int c, const string& n, const string& cat, const string& subCat, const string& st, const string& r, double p, int q)
+    : code(c), name(n), price(p), quantity(q) {
+    Taxonomy& taxonomy = Taxonomy::instance();
+    category = static_cast<uint8_t>(taxonomy.categories.intern(cat));
+    subCategory = taxonomy.subCategories.intern(subCat);
+    skinType = static_cast<uint8_t>(taxonomy.skinTypes.intern(st));
+    range = static_cast<uint8_t>(taxonomy.ranges.intern(r));
+}
+
+const string& Product::categoryName() const {
+    return Taxonomy::instance().categories.name(category);
+}
+
+const string& Product::subCategoryName() const {
+    return Taxonomy::instance().subCategories.name(subCategory);
+}
+
+const string& Product::skinTypeName() const {
+    return Taxonomy::instance().skinTypes.name(skinType);
+}
+
+const string& Product::rangeName() const {
+    return Taxonomy::instance().ranges.name(range);
+}
+
+string Product::serialize() const {
+    string out;
+    serializeTo(out);
+    return out;
+}
+
+void Product::serializeTo(string& out) const {
+    appendInt(out, code);
+    out += ',';
+    out += name;
+    out += ',';
+    out += categoryName();
+    out += ',';
+    out += subCategoryName();
+    out += ',';
+    out += skinTypeName();
+    out += ',';
+    out += rangeName();
+    out += ',';
+    // Same text as to_string(double): fixed notation, six decimals
+    char buffer[64];
+    auto result = to_chars(buffer, buffer + sizeof(buffer), price, chars_format::fixed, 6);
+    out.append(buffer, result.ptr);
+    out += ',';
+    appendInt(out, quantity);
+    if (!imagePath.empty()) {
+        out += ',';
+        out += imagePath;
+    }
+    out += '\n';
+}
+
+Product Product::deserialize(const string& str) {
+    Product product;
+    if (parse(str, product) != ParseError::None) {
+        throw invalid_argument("Malformed input string for Product deserialization");
+    }
+    return product;
+}
+
+ParseError Product::parse(string_view text, Product& product) {
+    if (trimLineEnd(text).empty()) return ParseError::EmptyRecord;
+    string_view fields[7];
+    for (string_view& field : fields) {
+        if (!nextField(text, field)) return ParseError::MissingField;
+    }
+    // The optional image path is the rest of the line, so it may contain commas
+    string_view quantity = text;
+    string_view imagePath;
+    size_t comma = text.find(',');
+    if (comma != string_view::npos) {
+        quantity = text.substr(0, comma);
+        imagePath = trimLineEnd(text.substr(comma + 1));
+    }
+    if (!parseNumber(fields[0], product.code) || !parseNumber(fields[6], product.price) || !parseNumber(quantity, product.quantity)) {
+        return ParseError::BadNumber;
+    }
+    Taxonomy& taxonomy = Taxonomy::instance();
+    product.name.assign(fields[1]);
+    product.imagePath.assign(imagePath);
+    product.category = static_cast<uint8_t>(taxonomy.categories.intern(fields[2]));
+    product.subCategory = taxonomy.subCategories.intern(fields[3]);
+    product.skinType = static_cast<uint8_t>(taxonomy.skinTypes.intern(fields[4]));
+    product.range = static_cast<uint8_t>(taxonomy.ranges.intern(fields[5]));
+    return ParseError::None;
+}
+
+// Order class implementation
+Order::Order() : placedAt(0) {}
+
+Order::Order(const string& cn, const string& a, const string& c, const string& e, const vector<Product>& p)
+    : customerName(cn), address(a), contact(c), email(e), placedAt(0), products(p) {}
+
+string Order::serialize() const {
+    string out;
+    serializeTo(out);
+    return out;
+}
+
+void Order::serializeTo(string& out) const {
+    out += customerName;
+    out += ',';
+    out += address;
+    out += ',';
+    out += contact;
+    out += ',';
+    out += email;
+    if (placedAt != 0) {
+        out += ',';
+        appendInt(out, placedAt);
+    }
+    out += '\n';
+    for (const auto& product : products) {
+        product.serializeTo(out);
+    }
+}
+
+Order Order::deserialize(const string& str) {
+    Order order;
+    if (parse(str, order) != ParseError::None) {
+        throw invalid_argument("Malformed input string for Order deserialization");
+    }
+    LOG_VERBOSE(logOrders) << "Deserialized order for " << order.customerName << ", " << order.products.size() << " items";
+    return order;
+}
+
+ParseError Order::parse(string_view text, Order& order) {
+    if (trimLineEnd(text).empty()) return ParseError::EmptyRecord;
+    size_t headerEnd = text.find('\n');
+    if (headerEnd == string_view::npos) return ParseError::MissingField;
+    string_view header = text.substr(0, headerEnd);
+    string_view body = text.substr(headerEnd + 1);
+
+    string_view customerName;
+    string_view address;
+    string_view contact;
+    if (!nextField(header, customerName) || !nextField(header, address) || !nextField(header, contact)) {
+        return ParseError::MissingField;
+    }
+    order.customerName.assign(customerName);
+    order.address.assign(address);
+    order.contact.assign(contact);
+    // A trailing number after the email is the order time
+    string_view email = trimLineEnd(header);
+    order.placedAt = 0;
+    size_t comma = email.rfind(',');
+    if (comma != string_view::npos && parseNumber(email.substr(comma + 1), order.placedAt)) {
+        email = email.substr(0, comma);
+    } else {
+        order.placedAt = 0;
+    }
+    order.email.assign(email);
+
+    // Size the product list up front so existing Product storage is reused
+    size_t lines = 0;
+    for (size_t start = 0; start < body.size();) {
+        size_t end = body.find('\n', start);
+        if (end == string_view::npos) end = body.size();
+        if (!trimLineEnd(body.substr(start, end - start)).empty()) ++lines;
+        start = end + 1;
+    }
+    order.products.resize(lines);
+
+    size_t index = 0;
+    for (size_t start = 0; start < body.size();) {
+        size_t end = body.find('\n', start);
+        if (end == string_view::npos) end = body.size();
+        string_view line = trimLineEnd(body.substr(start, end - start));
+        start = end + 1;
+        if (line.empty()) continue;
+        // A bad product line loses that product only, not the whole order
+        ParseError error = Product::parse(line, order.products[index]);
+        if (error != ParseError::None) {
+            LOG_WARNING(logOrders) << "Error deserializing product: " << parseErrorMessage(error);
+            continue;
+        }
+        ++index;
+    }
+    order.products.resize(index);
+    return ParseError::None;
+}
+
+// ProductBST implementation
+static int nodeHeight(ProductNode* node) {
+    return node ? node->height : 0;
+}
+
+static void updateHeight(ProductNode* node) {
+    node->height = 1 + max(nodeHeight(node->left), nodeHeight(node->right));
+}
+
+void ProductBST::addProduct(const Product& product) {
+    SCOPED_LATENCY("ProductBST::addProduct");
+    // Walk down remembering the path, then rebalance on the way back up
+    vector<ProductNode*> path;
+    ProductNode** link = &root;
+    while (*link) {
+        ProductNode* node = *link;
+        if (product.code == node->product.code) {
+            index.erase(node);
+            node->product = product;
+            index.insert(node);
+            ++changes;
+            return;
+        }
+        path.push_back(node);
+        link = product.code < node->product.code ? &node->left : &node->right;
+    }
+    *link = new ProductNode(product);
+    index.insert(*link);
+    ++count;
+    ++changes;
+    rebalancePath(path);
+}
+
+Product* ProductBST::findProduct(int code) {
+    SCOPED_LATENCY("ProductBST::findProduct");
+    ProductNode* current = root;
+    while (current) {
+        if (code == current->product.code) return &(current->product);
+        current = code < current->product.code ? current->left : current->right;
+    }
+    return nullptr;
+}
+
+bool ProductBST::updateProduct(const Product& product) {
+    SCOPED_LATENCY("ProductBST::updateProduct");
+    ProductNode* current = root;
+    while (current && current->product.code != product.code) {
+        current = product.code < current->product.code ? current->left : current->right;
+    }
+    if (!current) return false;
+    index.erase(current);
+    current->product = product;
+    index.insert(current);
+    ++changes;
+    return true;
+}
+
+void ProductBST::removeProduct(int code) {
+    SCOPED_LATENCY("ProductBST::removeProduct");
+    vector<ProductNode*> path;
+    ProductNode** link = &root;
+    while (*link && (*link)->product.code != code) {
+        path.push_back(*link);
+        link = code < (*link)->product.code ? &(*link)->left : &(*link)->right;
+    }
+    ProductNode* node = *link;
+    if (!node) return;
+    index.erase(node);
+
+    if (node->left && node->right) {
+        // Splice the in-order successor into the removed node's place so every
+        // other product keeps its node (and any Product* handed out stays valid)
+        size_t slot = path.size();
+        path.push_back(nullptr);
+        ProductNode* successorParent = node;
+        ProductNode* successor = node->right;
+        while (successor->left) {
+            path.push_back(successor);
+            successorParent = successor;
+            successor = successor->left;
+        }
+        if (successorParent != node) {
+            successorParent->left = successor->right;
+            successor->right = node->right;
+        }
+        successor->left = node->left;
+        *link = successor;
+        path[slot] = successor;
+    } else {
+        *link = node->left ? node->left : node->right;
+    }
+    delete node;
+    --count;
+    ++changes;
+    rebalancePath(path);
+}
+
+void ProductBST::buildFromSorted(vector<Product>& sorted) {
+    SCOPED_LATENCY("ProductBST::buildFromSorted");
+    clear();
+    bool ascending = true;
+    for (size_t i = 1; i < sorted.size() && ascending; ++i) {
+        ascending = sorted[i - 1].code < sorted[i].code;
+    }
+    if (!ascending) {
+        stable_sort(sorted.begin(), sorted.end(), [](const Product& a, const Product& b) {
+            return a.code < b.code;
+        });
+        // Keep the last record for each code
+        vector<Product> unique;
+        unique.reserve(sorted.size());
+        for (size_t i = 0; i < sorted.size(); ++i) {
+            if (i + 1 < sorted.size() && sorted[i + 1].code == sorted[i].code) continue;
+            unique.push_back(move(sorted[i]));
+        }
+        sorted.swap(unique);
+    }
+
+    // Split each range at its midpoint; a range of n products becomes a
+    // subtree of height bit_width(n), so sibling heights differ by at most one
+    struct Range {
+        size_t begin;
+        size_t end;
+        ProductNode** link;
+    };
+    stack<Range> ranges;
+    ranges.push({0, sorted.size(), &root});
+    while (!ranges.empty()) {
+        Range range = ranges.top();
+        ranges.pop();
+        if (range.begin >= range.end) continue;
+        size_t mid = range.begin + (range.end - range.begin) / 2;
+        ProductNode* node = new ProductNode(move(sorted[mid]));
+        size_t span = range.end - range.begin;
+        node->height = 0;
+        while (span) {
+            ++node->height;
+            span >>= 1;
+        }
+        index.insert(node);
+        *range.link = node;
+        ranges.push({range.begin, mid, &node->left});
+        ranges.push({mid + 1, range.end, &node->right});
+    }
+    count = sorted.size();
+    sorted.clear();
+}
+
+void ProductBST::rebalancePath(vector<ProductNode*>& path) {
+    for (size_t i = path.size(); i-- > 0;) {
+        ProductNode* node = path[i];
+        ProductNode* balanced = rebalance(node);
+        if (balanced == node) continue;
+        if (i == 0) {
+            root = balanced;
+        } else if (path[i - 1]->left == node) {
+            path[i - 1]->left = balanced;
+        } else {
+            path[i - 1]->right = balanced;
+        }
+    }
+}
+
+ProductNode* ProductBST::rebalance(ProductNode* node) {
+    updateHeight(node);
+    int balance = nodeHeight(node->left) - nodeHeight(node->right);
+    if (balance > 1) {
+        if (nodeHeight(node->left->left) < nodeHeight(node->left->right))
+            node->left = rotateLeft(node->left);
+        return rotateRight(node);
+    }
+    if (balance < -1) {
+        if (nodeHeight(node->right->right) < nodeHeight(node->right->left))
+            node->right = rotateRight(node->right);
+        return rotateLeft(node);
+    }
+    return node;
+}
+
+ProductNode* ProductBST::rotateLeft(ProductNode* node) {
+    ProductNode* pivot = node->right;
+    node->right = pivot->left;
+    pivot->left = node;
+    updateHeight(node);
+    updateHeight(pivot);
+    return pivot;
+}
+
+ProductNode* ProductBST::rotateRight(ProductNode* node) {
+    ProductNode* pivot = node->left;
+    node->left = pivot->right;
+    pivot->right = node;
+    updateHeight(node);
+    updateHeight(pivot);
+    return pivot;
+}
+
+vector<ProductNode*> ProductBST::query(const ProductFilter& filter) const {
+    SCOPED_LATENCY("ProductBST::query");
+    return index.query(filter);
+}
+
+vector<ProductNode*> ProductBST::searchName(string_view text, NameMatch mode, size_t limit) const {
+    SCOPED_LATENCY("ProductBST::searchName");
+    return index.searchName(text, mode, limit);
+}
+
+vector<NameHit> ProductBST::matchName(NameMatcher& matcher) const {
+    SCOPED_LATENCY("ProductBST::matchName");
+    return index.matchName(matcher);
+}
+
+vector<ProductNode*> ProductBST::fuzzySearch(string_view text, int maxDistance, size_t limit, const function<bool(const Product&)>& accept) const {
+    SCOPED_LATENCY("ProductBST::fuzzySearch");
+    return index.fuzzySearch(text, maxDistance, limit, accept);
+}
+
+size_t ProductBST::memoryUsed() const {
+    size_t bytes = sizeof(ProductBST) + index.memoryUsed();
+    forEachNodeInOrder([&](ProductNode* node) {
+        bytes += sizeof(ProductNode) + productHeapBytes(node->product);
+    });
+    return bytes;
+}
+
+vector<ProductNode*> ProductBST::nodesInOrder() const {
+    SCOPED_LATENCY("ProductBST::nodesInOrder");
+    vector<ProductNode*> nodes;
+    nodes.reserve(count);
+    forEachNodeInOrder([&](ProductNode* node) { nodes.push_back(node); });
+    return nodes;
+}
+
+void ProductBST::swap(ProductBST& other) {
+    std::swap(root, other.root);
+    std::swap(count, other.count);
+    std::swap(index, other.index);
+    // Past both old revisions, so nothing cached against either one matches
+    changes = other.changes = max(changes, other.changes) + 1;
+}
+
+void ProductBST::clear() {
+    SCOPED_LATENCY("ProductBST::clear");
+    stack<ProductNode*> nodes;
+    if (root) nodes.push(root);
+    while (!nodes.empty()) {
+        ProductNode* node = nodes.top();
+        nodes.pop();
+        if (node->left) nodes.push(node->left);
+        if (node->right) nodes.push(node->right);
+        delete node;
+    }
+    root = nullptr;
+    count = 0;
+    ++changes;
+    index.clear();
+}
+
+// OrderQueue implementation
+size_t OrderQueue::memoryUsed() const {
+    size_t bytes = sizeof(OrderQueue) + orders.size() * sizeof(Order);
+    for (const Order& order : orders) {
+        bytes += stringHeapBytes(order.customerName) + stringHeapBytes(order.address) + stringHeapBytes(order.contact) + stringHeapBytes(order.email);
+        bytes += order.products.capacity() * sizeof(Product);
+        for (const Product& product : order.products) {
+            bytes += productHeapBytes(product);
+        }
+    }
+    return bytes;
+}
@@ -0,0 +1,262 @@
+#ifndef MODELS_H
+#define MODELS_H
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <stack>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "product_index.h"
+
+using namespace std;
+
+// Outcome of the non-throwing parse() functions
+enum class ParseError {
+    None,
+    MissingField,
+    BadNumber,
+    EmptyRecord
+};
+
+const char* parseErrorMessage(ParseError error);
+// Locale-independent number parsing with std::from_chars; surrounding spaces
+// and a trailing line break are allowed
+bool parseNumber(string_view text, int& value);
+bool parseNumber(string_view text, long long& value);
+bool parseNumber(string_view text, double& value);
+
+// User class definition
+class User {
+public:
+    string username;
+    string password;
+    bool isStaff;
+
+    User();
+    User(const string& u, const string& p, bool s);
+    string serialize() const;
+    // Appends the serialized user to out
+    void serializeTo(string& out) const;
+    static User deserialize(const string& str);
+    // Parses into user, reusing its storage; never throws
+    static ParseError parse(string_view text, User& user);
+};
+
+// Product class definition
+// The four taxonomy attributes are stored as Taxonomy ids; their text form is
+// only needed for serialization and display. imagePath is optional and is
+// serialized as a ninth field only when set.
+class Product {
+public:
+    int code;
+    string name;
+    string imagePath;
+    double price;
+    int quantity;
+    uint16_t subCategory;
+    uint8_t category;
+    uint8_t skinType;
+    uint8_t range;
+
+    Product();
+    Product(int c, const string& n, const string& cat, const string& subCat, const string& st, const string& r, double p, int q);
+    const string& categoryName() const;
+    const string& subCategoryName() const;
+    const string& skinTypeName() const;
+    const string& rangeName() const;
+    string serialize() const;
+    void serializeTo(string& out) const;
+    static Product deserialize(const string& str);
+    static ParseError parse(string_view text, Product& product);
+};
+
+// Order class definition
+// The header line is "customerName,address,contact,email[,placedAt]".
+// placedAt (seconds since the epoch) is 0 for orders saved before it existed.
+// Each following line is a product; one that doesn't parse is logged and
+// skipped, and the order keeps the rest.
+class Order {
+public:
+    string customerName;
+    string address;
+    string contact;
+    string email;
+    long long placedAt;
+    vector<Product> products;
+
+    Order();
+    Order(const string& cn, const string& a, const string& c, const string& e, const vector<Product>& p);
+    string serialize() const;
+    void serializeTo(string& out) const;
+    static Order deserialize(const string& str);
+    static ParseError parse(string_view text, Order& order);
+};
+
+// Open-addressing hash table of Users keyed by username (linear probing).
+// Hashes live in their own array so a probe sequence stays within a few cache
+// lines and only a hash match touches the User itself.
+class UserList {
+public:
+    struct Stats {
+        size_t size;
+        size_t capacity;
+        double loadFactor;
+        double averageProbeLength;
+        size_t maxProbeLength;
+    };
+
+    UserList();
+    // Returns false and keeps the existing user if the username is taken
+    bool addUser(const User& user);
+    User* findUser(const string& username);
+    size_t size() const { return count; }
+    Stats stats() const;
+    // Approximate bytes held, including the users' strings
+    size_t memoryUsed() const;
+
+private:
+    vector<uint64_t> hashes; // 0 marks an empty bucket
+    vector<User> entries;
+    size_t count;
+
+    static uint64_t hashOf(const string& username);
+    void grow();
+};
+
+// BST Node for Products
+struct ProductNode {
+    Product product;
+    ProductNode* left;
+    ProductNode* right;
+    int height;
+    uint32_t slot; // position in the ProductIndex bitmaps
+    ProductNode(const Product& p) : product(p), left(nullptr), right(nullptr), height(1), slot(0) {}
+    ProductNode(Product&& p) : product(move(p)), left(nullptr), right(nullptr), height(1), slot(0) {}
+};
+
+// Self-balancing (AVL) BST for Products, keyed by product code.
+// All operations are iterative so deep catalogs can't overflow the stack.
+class ProductBST {
+public:
+    ProductBST() : root(nullptr), count(0), changes(0) {}
+    ProductBST(const ProductBST&) = delete;
+    ProductBST& operator=(const ProductBST&) = delete;
+    ~ProductBST() {
+        clear();
+    }
+    // Inserting an existing code replaces that product's record
+    void addProduct(const Product& product);
+    Product* findProduct(int code);
+    // Replaces the record with the same code, keeping the search index in sync
+    bool updateProduct(const Product& product);
+    void removeProduct(int code);
+    // Replaces the catalog with products sorted by code, building a perfectly
+    // balanced tree in one pass. Unsorted input is sorted first, and for
+    // duplicate codes the last record wins.
+    void buildFromSorted(vector<Product>& sorted);
+    // Exchanges catalogs in constant time, so one can be built on another
+    // thread and then swapped in. Both revisions change.
+    void swap(ProductBST& other);
+    size_t size() const { return count; }
+    // Changes whenever products are added, edited or removed
+    size_t revision() const { return changes; }
+    // Visits every node in code order
+    template <typename Visitor>
+    void forEachNodeInOrder(Visitor visit) const {
+        stack<ProductNode*> nodes;
+        ProductNode* current = root;
+        while (current || !nodes.empty()) {
+            while (current) {
+                nodes.push(current);
+                current = current->left;
+            }
+            current = nodes.top();
+            nodes.pop();
+            visit(current);
+            current = current->right;
+        }
+    }
+    // Visits every product in code order
+    template <typename Visitor>
+    void forEachInOrder(Visitor visit) const {
+        forEachNodeInOrder([&](ProductNode* node) { visit(static_cast<const Product&>(node->product)); });
+    }
+    // All nodes in code order. Node pointers stay valid until that product is
+    // removed; edits keep the node.
+    vector<ProductNode*> nodesInOrder() const;
+    // Nodes matching filter, in code order
+    vector<ProductNode*> query(const ProductFilter& filter) const;
+    // Nodes whose names contain text (or, with NameMatch::Prefix, have a word
+    // starting with it), best match first: the whole name, then the start of
+    // the name, then the start of a word, then anywhere
+    vector<ProductNode*> searchName(string_view text, NameMatch mode = NameMatch::Substring, size_t limit = SIZE_MAX) const;
+    // Every node whose name matches, with its rank, in no particular order
+    vector<NameHit> matchName(NameMatcher& matcher) const;
+    // Up to limit nodes whose names are within maxDistance typos of text,
+    // closest first. Tolerates misspellings such as "clenser" for "Cleanser".
+    vector<ProductNode*> fuzzySearch(string_view text, int maxDistance, size_t limit, const function<bool(const Product&)>& accept = nullptr) const;
+    // Approximate bytes held by the nodes, their strings and the search index.
+    // Walks the whole tree.
+    size_t memoryUsed() const;
+    void clear();
+
+    ProductNode* root;
+
+private:
+    size_t count;
+    size_t changes;
+    ProductIndex index;
+
+    void rebalancePath(vector<ProductNode*>& path);
+    ProductNode* rebalance(ProductNode* node);
+    ProductNode* rotateLeft(ProductNode* node);
+    ProductNode* rotateRight(ProductNode* node);
+};
+
+// Order Queue
+class OrderQueue {
+public:
+    OrderQueue() = default;
+    OrderQueue(const OrderQueue& other) {
+        orders = other.orders;
+    }
+    OrderQueue& operator=(const OrderQueue& other) {
+        if (this != &other) {
+            orders = other.orders;
+        }
+        return *this;
+    }
+    OrderQueue(OrderQueue&& other) = default;
+    OrderQueue& operator=(OrderQueue&& other) = default;
+    void enqueue(const Order& order) {
+        orders.push_back(order);
+    }
+    void enqueue(Order&& order) {
+        orders.push_back(move(order));
+    }
+    bool dequeue(Order& order) {
+        if (orders.empty()) return false;
+        order = move(orders.front());
+        orders.pop_front();
+        return true;
+    }
+    bool empty() const {
+        return orders.empty();
+    }
+    // Read access in queue order (oldest first), without copying
+    size_t size() const {
+        return orders.size();
+    }
+    const Order& at(size_t index) const {
+        return orders[index];
+    }
+    // Approximate bytes held, including every order's line items
+    size_t memoryUsed() const;
+
+private:
+    deque<Order> orders;
+};
+
+#endif // MODELS_H
@@ -0,0 +1,351 @@
+#include "name_index.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+
+bool isWordByte(unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c >= 0x80;
+}
+
+uint32_t trigramKey(const char* text) {
+    return (uint32_t(static_cast<unsigned char>(text[0])) << 16) | (uint32_t(static_cast<unsigned char>(text[1])) << 8) |
+           uint32_t(static_cast<unsigned char>(text[2]));
+}
+
+void addTrigrams(const string& padded, vector<uint32_t>& out) {
+    for (size_t i = 0; i + 3 <= padded.size(); ++i) {
+        out.push_back(trigramKey(padded.data() + i));
+    }
+}
+
+// Adds value to the sorted values; false when it was already there
+bool insertSorted(vector<uint32_t>& values, uint32_t value) {
+    auto at = lower_bound(values.begin(), values.end(), value);
+    if (at != values.end() && *at == value) return false;
+    values.insert(at, value);
+    return true;
+}
+
+// Drops value from the sorted values; false when it wasn't there
+bool eraseSorted(vector<uint32_t>& values, uint32_t value) {
+    auto at = lower_bound(values.begin(), values.end(), value);
+    if (at == values.end() || *at != value) return false;
+    values.erase(at);
+    return true;
+}
+
+// Per-thread counters for TrigramIndex::slotsSharing, one per slot. Each call
+// counts up from the highest value an earlier call can have left, so any
+// count below that base reads as zero and the buffer is never cleared.
+struct SharedCounters {
+    vector<uint32_t> counts;
+    uint32_t top = 0;
+};
+
+// Calls visit for each space-separated word of a normalized name
+template <typename Visitor>
+void forEachWord(string_view name, Visitor visit) {
+    size_t start = 0;
+    while (start < name.size()) {
+        size_t end = name.find(' ', start);
+        if (end == string_view::npos) end = name.size();
+        visit(name.substr(start, end - start));
+        start = end + 1;
+    }
+}
+
+}
+
+void normalizeNameTo(string_view name, string& out) {
+    out.clear();
+    bool gap = false;
+    for (char c : name) {
+        unsigned char byte = static_cast<unsigned char>(c);
+        if (!isWordByte(byte)) {
+            gap = true;
+            continue;
+        }
+        if (gap && !out.empty()) out += ' ';
+        gap = false;
+        out += (byte >= 'A' && byte <= 'Z') ? static_cast<char>(byte - 'A' + 'a') : c;
+    }
+}
+
+string normalizeName(string_view name) {
+    string normalized;
+    normalizeNameTo(name, normalized);
+    return normalized;
+}
+
+// NameMatcher implementation
+NameMatcher::NameMatcher(string_view query, NameMatch mode) : normalizedQuery(normalizeName(query)), matchMode(mode) {}
+
+NameMatcher::Rank NameMatcher::rank(string_view name) {
+    if (normalizedQuery.empty()) return Inside;
+    // Most names don't match at all; rule out those without the query's first
+    // character before paying for normalization
+    char first = normalizedQuery[0];
+    char upper = (first >= 'a' && first <= 'z') ? static_cast<char>(first - 'a' + 'A') : first;
+    if (name.find(first) == string_view::npos && (upper == first || name.find(upper) == string_view::npos)) return NoMatch;
+    normalizeNameTo(name, buffer);
+    if (buffer == normalizedQuery) return Exact;
+    Rank best = NoMatch;
+    for (size_t at = buffer.find(normalizedQuery); at != string::npos; at = buffer.find(normalizedQuery, at + 1)) {
+        if (at == 0) return NamePrefix;
+        if (buffer[at - 1] == ' ') return WordPrefix;
+        best = Inside;
+    }
+    return matchMode == NameMatch::Prefix ? NoMatch : best;
+}
+
+// TrigramIndex implementation
+void TrigramIndex::wordTrigrams(string_view name, vector<uint32_t>& out) {
+    out.clear();
+    string padded;
+    forEachWord(name, [&](string_view word) {
+        padded.assign("  ");
+        padded.append(word);
+        padded += ' ';
+        addTrigrams(padded, out);
+    });
+    sort(out.begin(), out.end());
+    out.erase(unique(out.begin(), out.end()), out.end());
+}
+
+void TrigramIndex::Postings::add(uint32_t slot) {
+    if (eraseSorted(removed, slot)) return;
+    // Bulk loads hand out slots in ascending order, so this is almost always an append
+    if (sorted.empty() || sorted.back() < slot) {
+        if (!binary_search(added.begin(), added.end(), slot)) sorted.push_back(slot);
+        return;
+    }
+    if (!binary_search(sorted.begin(), sorted.end(), slot) && insertSorted(added, slot)) compactIfDue();
+}
+
+void TrigramIndex::Postings::remove(uint32_t slot) {
+    if (eraseSorted(added, slot)) return;
+    if (binary_search(sorted.begin(), sorted.end(), slot) && insertSorted(removed, slot)) compactIfDue();
+}
+
+const vector<uint32_t>& TrigramIndex::Postings::view(vector<uint32_t>& scratch) const {
+    if (added.empty() && removed.empty()) return sorted;
+    scratch.clear();
+    scratch.reserve(size());
+    auto next = added.begin();
+    auto dropped = removed.begin();
+    for (uint32_t slot : sorted) {
+        while (next != added.end() && *next < slot) scratch.push_back(*next++);
+        if (dropped != removed.end() && *dropped == slot) {
+            ++dropped;
+            continue;
+        }
+        scratch.push_back(slot);
+    }
+    scratch.insert(scratch.end(), next, added.end());
+    return scratch;
+}
+
+void TrigramIndex::Postings::retainIn(vector<uint32_t>& out) const {
+    auto from = sorted.begin();
+    auto next = added.begin();
+    auto dropped = removed.begin();
+    size_t kept = 0;
+    for (uint32_t slot : out) {
+        while (from != sorted.end() && *from < slot) ++from;
+        bool listed;
+        if (from != sorted.end() && *from == slot) {
+            while (dropped != removed.end() && *dropped < slot) ++dropped;
+            listed = dropped == removed.end() || *dropped != slot;
+        } else {
+            while (next != added.end() && *next < slot) ++next;
+            listed = next != added.end() && *next == slot;
+        }
+        if (listed) out[kept++] = slot;
+    }
+    out.resize(kept);
+}
+
+// Folding the changes in moves the whole list, so it waits until they number
+// a 64th of it; each change then costs a few moves on average, and the side
+// lists stay short enough to insert into cheaply. It works in place, since a
+// fresh buffer the size of a long list costs more than the merge.
+void TrigramIndex::Postings::compactIfDue() {
+    if (added.size() + removed.size() <= max<size_t>(16, sorted.size() / 64)) return;
+    size_t kept = 0;
+    auto dropped = removed.begin();
+    for (uint32_t slot : sorted) {
+        if (dropped != removed.end() && *dropped == slot) {
+            ++dropped;
+            continue;
+        }
+        sorted[kept++] = slot;
+    }
+    // Merge the added slots in from the back, so nothing is overwritten early
+    sorted.resize(kept + added.size());
+    size_t from = kept;
+    size_t next = added.size();
+    size_t to = sorted.size();
+    while (next > 0) {
+        if (from > 0 && sorted[from - 1] > added[next - 1]) {
+            sorted[--to] = sorted[--from];
+        } else {
+            sorted[--to] = added[--next];
+        }
+    }
+    added.clear();
+    removed.clear();
+}
+
+void TrigramIndex::insert(uint32_t slot, string_view name) {
+    vector<uint32_t> trigrams;
+    wordTrigrams(normalizeName(name), trigrams);
+    for (uint32_t trigram : trigrams) {
+        postings[trigram].add(slot);
+    }
+}
+
+void TrigramIndex::erase(uint32_t slot, string_view name) {
+    vector<uint32_t> trigrams;
+    wordTrigrams(normalizeName(name), trigrams);
+    for (uint32_t trigram : trigrams) {
+        auto list = postings.find(trigram);
+        if (list == postings.end()) continue;
+        list->second.remove(slot);
+        if (list->second.size() == 0) postings.erase(list);
+    }
+}
+
+void TrigramIndex::slotsSharing(const vector<uint32_t>& trigrams, size_t minShared, vector<uint32_t>& out) const {
+    out.clear();
+    vector<const Postings*> lists;
+    uint32_t lastSlot = 0;
+    for (uint32_t trigram : trigrams) {
+        auto list = postings.find(trigram);
+        if (list == postings.end()) continue;
+        const Postings& listed = list->second;
+        lists.push_back(&listed);
+        if (!listed.sorted.empty()) lastSlot = max(lastSlot, listed.sorted.back());
+        if (!listed.added.empty()) lastSlot = max(lastSlot, listed.added.back());
+    }
+    if (lists.size() < minShared || lists.empty()) return;
+    // Count the lists each slot appears in; a slot is taken once its count
+    // reaches minShared
+    thread_local SharedCounters counters;
+    if (counters.counts.size() <= lastSlot) counters.counts.resize(size_t(lastSlot) + 1, 0);
+    if (counters.top > UINT32_MAX - lists.size()) {
+        fill(counters.counts.begin(), counters.counts.end(), 0);
+        counters.top = 0;
+    }
+    uint32_t base = counters.top;
+    counters.top += static_cast<uint32_t>(lists.size());
+    vector<uint32_t> scratch;
+    for (const Postings* list : lists) {
+        for (uint32_t slot : list->view(scratch)) {
+            uint32_t& count = counters.counts[slot];
+            if (count < base) count = base;
+            if (++count - base == minShared) out.push_back(slot);
+        }
+    }
+    sort(out.begin(), out.end());
+}
+
+void TrigramIndex::clear() {
+    postings.clear();
+}
+
+size_t TrigramIndex::memoryUsed() const {
+    // One bucket pointer per bucket, and per entry a node holding the pair
+    // and a next pointer
+    size_t bytes = postings.bucket_count() * sizeof(void*);
+    for (const auto& entry : postings) {
+        const Postings& list = entry.second;
+        bytes += sizeof(entry) + sizeof(void*) + (list.sorted.capacity() + list.added.capacity() + list.removed.capacity()) * sizeof(uint32_t);
+    }
+    return bytes;
+}
+
+// A query word is padded on each side where the query says a word boundary
+// is: between its words, and before the first one in Prefix mode. Query words
+// too short to form a trigram even with padding become fragments.
+void TrigramIndex::queryTrigrams(const NameMatcher& matcher, vector<uint32_t>& trigrams, vector<string>& fragments) {
+    const string& query = matcher.query();
+    size_t words = count(query.begin(), query.end(), ' ') + 1;
+    size_t index = 0;
+    string padded;
+    forEachWord(query, [&](string_view word) {
+        padded.assign(index > 0 || matcher.mode() == NameMatch::Prefix ? "  " : "");
+        padded.append(word);
+        if (index + 1 < words) padded += ' ';
+        if (padded.size() >= 3) {
+            addTrigrams(padded, trigrams);
+        } else {
+            fragments.push_back(padded);
+        }
+        ++index;
+    });
+    sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(unique(trigrams.begin(), trigrams.end()), trigrams.end());
+}
+
+bool TrigramIndex::hasTrigrams(const NameMatcher& matcher) {
+    if (matcher.query().empty()) return false;
+    vector<uint32_t> trigrams;
+    vector<string> fragments;
+    queryTrigrams(matcher, trigrams, fragments);
+    return !trigrams.empty();
+}
+
+bool TrigramIndex::candidates(const NameMatcher& matcher, size_t slotCount, vector<uint32_t>& out) const {
+    out.clear();
+    if (matcher.query().empty()) return false;
+    vector<uint32_t> trigrams;
+    vector<string> fragments;
+    queryTrigrams(matcher, trigrams, fragments);
+
+    if (!trigrams.empty()) {
+        // Intersect the posting lists, shortest first
+        vector<const Postings*> lists;
+        for (uint32_t trigram : trigrams) {
+            auto list = postings.find(trigram);
+            if (list == postings.end()) return true;
+            lists.push_back(&list->second);
+        }
+        sort(lists.begin(), lists.end(), [](const Postings* a, const Postings* b) {
+            return a->size() < b->size();
+        });
+        vector<uint32_t> scratch;
+        out = lists.front()->view(scratch);
+        for (size_t i = 1; i < lists.size() && !out.empty(); ++i) {
+            lists[i]->retainIn(out);
+        }
+        return true;
+    }
+
+    // A one or two character query: its matches are the union of every
+    // trigram containing it. That is only worth merging while it stays well
+    // below the catalog size.
+    const string& fragment = *max_element(fragments.begin(), fragments.end(), [](const string& a, const string& b) {
+        return a.size() < b.size();
+    });
+    size_t budget = slotCount / 4;
+    size_t total = 0;
+    vector<const Postings*> lists;
+    for (const auto& entry : postings) {
+        char text[3] = {static_cast<char>(entry.first >> 16), static_cast<char>(entry.first >> 8), static_cast<char>(entry.first)};
+        if (string_view(text, 3).find(fragment) == string_view::npos) continue;
+        total += entry.second.size();
+        if (total > budget) return false;
+        lists.push_back(&entry.second);
+    }
+    out.reserve(total);
+    vector<uint32_t> scratch;
+    for (const Postings* list : lists) {
+        const vector<uint32_t>& listed = list->view(scratch);
+        out.insert(out.end(), listed.begin(), listed.end());
+    }
+    sort(out.begin(), out.end());
+    out.erase(unique(out.begin(), out.end()), out.end());
+    return true;
+}
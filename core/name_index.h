@@ -0,0 +1,99 @@
+#ifndef NAME_INDEX_H
+#define NAME_INDEX_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// How a name query has to line up with a product name
+enum class NameMatch {
+    Substring, // anywhere in the name
+    Prefix     // at the start of a word
+};
+
+// The form names are indexed and compared in: ASCII letters lowercased,
+// every run of other punctuation and spaces turned into one space, trimmed.
+// Bytes outside ASCII are kept, so UTF-8 names still match themselves.
+string normalizeName(string_view name);
+void normalizeNameTo(string_view name, string& out);
+
+// Checks product names against one query and grades the match. Keeps a
+// buffer so checking many names doesn't allocate.
+class NameMatcher {
+public:
+    enum Rank { Exact, NamePrefix, WordPrefix, Inside, NoMatch };
+
+    NameMatcher(string_view query, NameMatch mode);
+    const string& query() const { return normalizedQuery; }
+    NameMatch mode() const { return matchMode; }
+    // The best place query occurs in name; NoMatch when it doesn't, or only
+    // occurs inside words in Prefix mode
+    Rank rank(string_view name);
+
+private:
+    string normalizedQuery;
+    NameMatch matchMode;
+    string buffer;
+};
+
+// Inverted index from the trigrams of normalized names to the slots holding
+// them. Each word is padded with two spaces in front and one behind, so
+// "  s", " se" and "ser" mark "ser" as the start of a word, and short word
+// prefixes still have a trigram of their own. Posting lists are kept sorted,
+// so queries intersect them in one merge. Slots added or removed later wait
+// in small side lists, so renaming a product doesn't shift the long ones.
+class TrigramIndex {
+public:
+    void insert(uint32_t slot, string_view name);
+    void erase(uint32_t slot, string_view name);
+    void clear();
+    // Collects, in ascending order, every slot whose name can match the
+    // matcher's query (and possibly some that don't). Returns false when the
+    // query is too short for the index to narrow down cheaply; the caller
+    // then has to check every name.
+    bool candidates(const NameMatcher& matcher, size_t slotCount, vector<uint32_t>& out) const;
+    // Whether the matcher's query has a trigram of its own, so candidates()
+    // narrows by intersecting posting lists rather than merging them
+    static bool hasTrigrams(const NameMatcher& matcher);
+    // Collects, in ascending order, every slot whose name has at least
+    // minShared (at least 1) of trigrams, which must be distinct
+    void slotsSharing(const vector<uint32_t>& trigrams, size_t minShared, vector<uint32_t>& out) const;
+    size_t trigramCount() const { return postings.size(); }
+    // Heap bytes held by the table and its posting lists, approximately
+    size_t memoryUsed() const;
+
+    // The distinct trigrams of a normalized name, sorted, with every word
+    // padded the way the index pads it
+    static void wordTrigrams(string_view name, vector<uint32_t>& out);
+
+private:
+    // One trigram's slots: the sorted list, plus the changes not yet folded
+    // into it. added holds slots missing from sorted, removed slots present
+    // in it; both are sorted and folded in once they outgrow a fraction of it.
+    struct Postings {
+        vector<uint32_t> sorted;
+        vector<uint32_t> added;
+        vector<uint32_t> removed;
+
+        size_t size() const { return sorted.size() + added.size() - removed.size(); }
+        void add(uint32_t slot);
+        void remove(uint32_t slot);
+        // The slots in ascending order, merged into scratch when changes are pending
+        const vector<uint32_t>& view(vector<uint32_t>& scratch) const;
+        // Drops the slots of out, which is sorted, that aren't in the list
+        void retainIn(vector<uint32_t>& out) const;
+
+    private:
+        void compactIfDue();
+    };
+
+    unordered_map<uint32_t, Postings> postings;
+
+    static void queryTrigrams(const NameMatcher& matcher, vector<uint32_t>& trigrams, vector<string>& fragments);
+};
+
+#endif // NAME_INDEX_H
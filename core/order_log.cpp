@@ -0,0 +1,262 @@
+#include "order_log.h"
+#include "log.h"
+#include "models.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+using namespace std;
+
+namespace {
+
+const char orderLogMagic[8] = {'C', 'C', 'O', 'R', 'D', 'E', 'R', 'S'};
+const uint32_t orderLogVersion = 1;
+const uint32_t maxRecordLength = 64 * 1024 * 1024;
+const size_t resyncWindow = 64 * 1024;
+
+void appendUint32(string& out, uint32_t value) {
+    char bytes[4] = {char(value & 0xff), char((value >> 8) & 0xff), char((value >> 16) & 0xff), char((value >> 24) & 0xff)};
+    out.append(bytes, 4);
+}
+
+uint32_t readUint32(const char* bytes) {
+    const unsigned char* b = reinterpret_cast<const unsigned char*>(bytes);
+    return uint32_t(b[0]) | (uint32_t(b[1]) << 8) | (uint32_t(b[2]) << 16) | (uint32_t(b[3]) << 24);
+}
+
+// A legacy product line is "code,name,category,subCategory,skinType,range,price,quantity"
+bool isLegacyProductLine(const string& line) {
+    if (count(line.begin(), line.end(), ',') < 7) return false;
+    size_t comma = line.find(',');
+    size_t start = (line[0] == '-') ? 1 : 0;
+    return comma > start && all_of(line.begin() + start, line.begin() + comma, [](char c) { return c >= '0' && c <= '9'; });
+}
+
+}
+
+uint32_t checksumCrc32(const char* data, size_t length) {
+    static uint32_t table[256];
+    static bool initialized = [] {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            table[i] = c;
+        }
+        return true;
+    }();
+    (void)initialized;
+
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; ++i) {
+        crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xff] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// OrderLogWriter implementation
+string OrderLogWriter::header() {
+    string header(orderLogMagic, sizeof(orderLogMagic));
+    appendUint32(header, orderLogVersion);
+    return header;
+}
+
+string OrderLogWriter::frame(const Order& order) {
+    string record;
+    frameTo(record, order);
+    return record;
+}
+
+void OrderLogWriter::frameTo(string& out, const Order& order) {
+    // Serialize straight after a placeholder frame header, then fill it in
+    size_t headerAt = out.size();
+    out.append(8, '\0');
+    order.serializeTo(out);
+    size_t length = out.size() - headerAt - 8;
+    string header;
+    appendUint32(header, static_cast<uint32_t>(length));
+    appendUint32(header, checksumCrc32(out.data() + headerAt + 8, length));
+    out.replace(headerAt, 8, header);
+}
+
+bool OrderLogWriter::append(const string& path, const Order& order) {
+    ofstream file(path, ios::binary | ios::app);
+    if (!file.is_open()) {
+        LOG_ERROR(logStorage) << "Unable to open " << path << " for writing";
+        return false;
+    }
+    file.seekp(0, ios::end);
+    if (file.tellp() == 0) {
+        file << header();
+    }
+    file << frame(order);
+    file.close();
+    return !file.fail();
+}
+
+// OrderLogReader implementation
+OrderLogReader::OrderLogReader(const string& path, uint64_t limit)
+    : path(path), file(path, ios::binary), open(false), damaged(false), tornTail(false), position(0), intactEnd(0), limit(0) {
+    char header[sizeof(orderLogMagic) + 4];
+    if (!file.read(header, sizeof(header))) return;
+    if (memcmp(header, orderLogMagic, sizeof(orderLogMagic)) != 0 || readUint32(header + sizeof(orderLogMagic)) != orderLogVersion) {
+        LOG_ERROR(logStorage) << "Unsupported order log " << path;
+        damaged = true;
+        return;
+    }
+    file.seekg(0, ios::end);
+    this->limit = min(limit, static_cast<uint64_t>(file.tellg()));
+    file.seekg(sizeof(header));
+    open = true;
+    position = intactEnd = sizeof(header);
+}
+
+bool OrderLogReader::next(Order& order) {
+    while (open) {
+        if (position >= limit) {
+            open = false;
+            return false;
+        }
+        char frameHeader[8];
+        file.read(frameHeader, sizeof(frameHeader));
+        uint32_t length = readUint32(frameHeader);
+        uint32_t checksum = readUint32(frameHeader + 4);
+        uint64_t left = limit - position;
+        bool intact = file.gcount() == sizeof(frameHeader) && left >= sizeof(frameHeader) && length <= maxRecordLength &&
+                      length <= left - sizeof(frameHeader);
+        if (intact) {
+            payload.resize(length);
+            intact = file.read(&payload[0], length) && checksumCrc32(payload.data(), length) == checksum;
+        }
+        if (!intact) {
+            damaged = true;
+            if (!resync(position)) {
+                open = false;
+                tornTail = true;
+                return false;
+            }
+            continue;
+        }
+        position += sizeof(frameHeader) + length;
+        intactEnd = position;
+        ParseError error = Order::parse(payload, order);
+        if (error == ParseError::None) return true;
+        // The frame is intact, so only this order is lost
+        LOG_WARNING(logOrders) << "Error deserializing order: " << parseErrorMessage(error);
+    }
+    return false;
+}
+
+// Scans the bytes after the damaged frame at damagedAt for the next frame
+// whose payload matches its CRC, and positions the reader on it. Every later
+// session appends after the damage, so the rest of the log can be large: it
+// is scanned a window at a time, and a candidate payload that runs past the
+// window is read from the file on its own.
+bool OrderLogReader::resync(uint64_t damagedAt) {
+    uint64_t end = limit;
+    string window;
+    for (uint64_t start = damagedAt + 1; start + 8 <= end; start += window.size() - 7) {
+        // Windows overlap by 7 bytes, so no frame header is split between two
+        window.resize(static_cast<size_t>(min<uint64_t>(resyncWindow, end - start)));
+        file.clear();
+        file.seekg(static_cast<streamoff>(start));
+        if (!file.read(&window[0], static_cast<streamsize>(window.size()))) break;
+        for (size_t at = 0; at + 8 <= window.size(); ++at) {
+            uint64_t frameAt = start + at;
+            uint32_t length = readUint32(&window[at]);
+            if (length == 0 || length > maxRecordLength || length > end - frameAt - 8) continue;
+            // Every payload ends with a line break; checking that first keeps the
+            // CRC off nearly every false candidate
+            const char* data = window.data() + at + 8;
+            if (at + 8 + length <= window.size()) {
+                if (data[length - 1] != '\n' || checksumCrc32(data, length) != readUint32(&window[at + 4])) continue;
+            } else if (!frameMatches(frameAt + 8, length, readUint32(&window[at + 4]))) {
+                continue;
+            }
+            position = frameAt;
+            LOG_WARNING(logStorage) << "Skipped " << position - damagedAt << " damaged bytes at offset " << damagedAt << " of " << path;
+            file.clear();
+            file.seekg(static_cast<streamoff>(position));
+            return true;
+        }
+        if (start + window.size() >= end) break;
+    }
+    LOG_WARNING(logStorage) << "Damaged bytes from offset " << damagedAt << " to the end of " << path;
+    return false;
+}
+
+// Whether the length bytes at offset end in a line break and match checksum
+bool OrderLogReader::frameMatches(uint64_t offset, uint32_t length, uint32_t checksum) {
+    file.clear();
+    file.seekg(static_cast<streamoff>(offset + length - 1));
+    if (file.get() != '\n') return false;
+    file.seekg(static_cast<streamoff>(offset));
+    payload.resize(length);
+    return file.read(&payload[0], length) && checksumCrc32(payload.data(), length) == checksum;
+}
+
+bool OrderLogReader::truncateTornTail() {
+    if (open || !tornTail) return false;
+    file.close();
+    error_code ec;
+    if (filesystem::file_size(path, ec) != limit || ec) return false;
+    filesystem::resize_file(path, intactEnd, ec);
+    if (ec) {
+        LOG_ERROR(logStorage) << "Unable to truncate " << path << ": " << ec.message();
+        return false;
+    }
+    tornTail = false;
+    LOG_INFO(logStorage) << "Truncated " << path << " to its last intact record";
+    return true;
+}
+
+bool migrateLegacyOrders(const string& legacyPath, const string& logPath) {
+    error_code ec;
+    if (filesystem::exists(logPath, ec) || !filesystem::exists(legacyPath, ec)) return false;
+
+    ifstream legacy(legacyPath);
+    string tempPath = logPath + ".tmp";
+    filesystem::remove(tempPath, ec);
+    string pending;
+    Order order;
+    size_t migrated = 0;
+    bool ok = true;
+    auto flush = [&]() {
+        if (pending.empty()) return;
+        ParseError error = Order::parse(pending, order);
+        if (error == ParseError::None) {
+            ok = OrderLogWriter::append(tempPath, order) && ok;
+            ++migrated;
+        } else {
+            LOG_WARNING(logOrders) << "Error migrating order: " << parseErrorMessage(error);
+        }
+        pending.clear();
+    };
+
+    // Each order is a header line followed by its product lines
+    string line;
+    while (getline(legacy, line)) {
+        if (line.empty()) continue;
+        if (!isLegacyProductLine(line)) {
+            flush();
+        } else if (pending.empty()) {
+            continue; // product line without an order header
+        }
+        pending += line;
+        pending += '\n';
+    }
+    flush();
+    legacy.close();
+
+    if (!ok) return false;
+    if (migrated == 0) {
+        // Still create the log so the migration doesn't run again
+        ofstream(tempPath, ios::binary) << OrderLogWriter::header();
+    }
+    filesystem::rename(tempPath, logPath, ec);
+    if (ec) return false;
+    filesystem::rename(legacyPath, legacyPath + ".migrated", ec);
+    LOG_INFO(logOrders) << "Migrated " << migrated << " orders from " << legacyPath;
+    return true;
+}
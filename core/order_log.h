@@ -0,0 +1,69 @@
+#ifndef ORDER_LOG_H
+#define ORDER_LOG_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+using namespace std;
+
+class Order;
+
+// Append-only order log (orders.log). After an 8-byte magic and a 4-byte
+// version, each order is one framed record:
+//     uint32 payload length | uint32 CRC-32 of payload | payload
+// The payload is Order::serialize(), which spans several lines; the framing
+// is what lets it round-trip. Integers are little-endian.
+class OrderLogWriter {
+public:
+    static bool append(const string& path, const Order& order);
+    // The magic and version that start every order log
+    static string header();
+    static string frame(const Order& order);
+    // Appends the framed record to out
+    static void frameTo(string& out, const Order& order);
+};
+
+// Streams records one at a time through a reused buffer, so reading never
+// holds more than one order's text in memory. A torn or corrupt record is
+// skipped: the reader resyncs on the next frame whose length and CRC check
+// out, so orders appended after a crash mid-append are still read. Only the
+// first limit bytes are read, so records appended while it reads are left
+// for the caller to account for.
+class OrderLogReader {
+public:
+    explicit OrderLogReader(const string& path, uint64_t limit = UINT64_MAX);
+    bool isOpen() const { return open; }
+    // Returns false at the end of the log
+    bool next(Order& order);
+    // True when damaged bytes were skipped or the log is unsupported
+    bool corrupt() const { return damaged; }
+    // Once next() has returned false: cuts damaged bytes after the last intact
+    // record off the log, so the next append follows intact data. Nothing
+    // else may write to the log meanwhile, and nothing is cut once it has
+    // grown past what was read. Returns true if it truncated.
+    bool truncateTornTail();
+
+private:
+    string path;
+    ifstream file;
+    string payload;
+    bool open;
+    bool damaged;
+    bool tornTail; // damaged bytes with no intact record after them
+    uint64_t position; // offset of the next frame
+    uint64_t intactEnd; // offset just past the last intact frame
+    uint64_t limit; // offset the reader stops at
+
+    bool resync(uint64_t damagedAt);
+    bool frameMatches(uint64_t offset, uint32_t length, uint32_t checksum);
+};
+
+uint32_t checksumCrc32(const char* data, size_t length);
+
+// One-time migration of the old line-based orders.txt, whose orders could not
+// be read back. Converts it into the order log and renames it to
+// <legacyPath>.migrated. Does nothing when the log already exists.
+bool migrateLegacyOrders(const string& legacyPath, const string& logPath);
+
+#endif // ORDER_LOG_H
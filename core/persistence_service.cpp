@@ -0,0 +1,291 @@
+#include "persistence_service.h"
+#include "log.h"
+#include "metrics.h"
+#include "trace.h"
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+// Plain file descriptors rather than streams, since streams can't fsync
+int openFile(const string& path, bool truncate) {
+#ifdef _WIN32
+    int flags = _O_WRONLY | _O_CREAT | _O_BINARY | (truncate ? _O_TRUNC : _O_APPEND);
+    return _open(path.c_str(), flags, _S_IREAD | _S_IWRITE);
+#else
+    int flags = O_WRONLY | O_CREAT | (truncate ? O_TRUNC : O_APPEND);
+    return ::open(path.c_str(), flags, 0644);
+#endif
+}
+
+bool isEmptyFile(int fd) {
+#ifdef _WIN32
+    return _lseeki64(fd, 0, SEEK_END) == 0;
+#else
+    return lseek(fd, 0, SEEK_END) == 0;
+#endif
+}
+
+bool writeAll(int fd, const string& bytes) {
+    size_t written = 0;
+    while (written < bytes.size()) {
+        size_t chunk = min<size_t>(bytes.size() - written, 1 << 30);
+#ifdef _WIN32
+        int result = _write(fd, bytes.data() + written, static_cast<unsigned int>(chunk));
+#else
+        ssize_t result = ::write(fd, bytes.data() + written, chunk);
+#endif
+        if (result <= 0) return false;
+        written += static_cast<size_t>(result);
+    }
+    return true;
+}
+
+bool syncFile(int fd) {
+#ifdef _WIN32
+    return _commit(fd) == 0;
+#else
+    return fsync(fd) == 0;
+#endif
+}
+
+bool closeFile(int fd) {
+#ifdef _WIN32
+    return _close(fd) == 0;
+#else
+    return ::close(fd) == 0;
+#endif
+}
+
+}
+
+PersistenceService::PersistenceService(size_t capacity, QObject* parent)
+    : QObject(parent), capacity(max<size_t>(capacity, 1)), busy(false), stopping(false),
+      syncPolicy(SyncPolicy::EveryCommit), syncInterval(1000), lastSync(chrono::steady_clock::now()) {
+    writer = std::thread(&PersistenceService::run, this);
+}
+
+PersistenceService::~PersistenceService() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    queued.notify_all();
+    writer.join();
+}
+
+void PersistenceService::setSyncPolicy(SyncPolicy policy, chrono::milliseconds interval) {
+    lock_guard<mutex> guard(lock);
+    syncPolicy = policy;
+    syncInterval = interval;
+}
+
+void PersistenceService::append(const string& path, string bytes, const string& header) {
+    SCOPED_LATENCY("PersistenceService::append");
+    unique_lock<mutex> guard(lock);
+    drained.wait(guard, [this] { return jobs.size() < capacity; });
+    jobs.push_back(Job{false, path, string(), string(), move(bytes), header});
+    guard.unlock();
+    queued.notify_one();
+}
+
+void PersistenceService::saveCatalog(const string& snapshotPath, const string& logPath, const string& rotatedLogPath, string snapshot) {
+    SCOPED_LATENCY("PersistenceService::saveCatalog");
+    unique_lock<mutex> guard(lock);
+    // A save still waiting in the queue is superseded by this one. Log records
+    // queued between the two are already part of the newer snapshot, and
+    // replaying them again is harmless, so only the newer save needs to run.
+    for (auto it = jobs.begin(); it != jobs.end(); ++it) {
+        if (it->catalog && it->path == snapshotPath) {
+            jobs.erase(it);
+            break;
+        }
+    }
+    drained.wait(guard, [this] { return jobs.size() < capacity; });
+    jobs.push_back(Job{true, snapshotPath, logPath, rotatedLogPath, move(snapshot), string()});
+    guard.unlock();
+    queued.notify_one();
+}
+
+void PersistenceService::flush() {
+    SCOPED_LATENCY("PersistenceService::flush");
+    unique_lock<mutex> guard(lock);
+    drained.wait(guard, [this] { return jobs.empty() && !busy; });
+}
+
+void PersistenceService::run() {
+    Trace::setThreadName("PersistenceService writer");
+    unique_lock<mutex> guard(lock);
+    while (true) {
+        if (jobs.empty()) {
+            busy = false;
+            drained.notify_all();
+            if (stopping) break;
+            if (syncPolicy == SyncPolicy::Periodic && !unsynced.empty()) {
+                // Wake up to sync files written at the end of a burst
+                if (!queued.wait_for(guard, syncInterval, [this] { return !jobs.empty() || stopping; })) {
+                    guard.unlock();
+                    syncPending();
+                    guard.lock();
+                }
+            } else {
+                queued.wait(guard, [this] { return !jobs.empty() || stopping; });
+            }
+            continue;
+        }
+
+        // Take either one catalog save, or every append queued ahead of the next one
+        busy = true;
+        deque<Job> batch;
+        if (jobs.front().catalog) {
+            batch.push_back(move(jobs.front()));
+            jobs.pop_front();
+        } else {
+            while (!jobs.empty() && !jobs.front().catalog) {
+                batch.push_back(move(jobs.front()));
+                jobs.pop_front();
+            }
+        }
+        guard.unlock();
+        drained.notify_all();
+
+        if (batch.front().catalog) {
+            emit catalogSaved(writeCatalog(batch.front()));
+        } else {
+            commitAppends(batch);
+        }
+        guard.lock();
+    }
+    guard.unlock();
+    syncPending();
+}
+
+void PersistenceService::commitAppends(deque<Job>& batch) {
+    SCOPED_LATENCY("PersistenceService::commitAppends");
+    // Gather the batch into one buffer per file, keeping each file's order
+    vector<Job*> files;
+    for (Job& job : batch) {
+        Job* file = nullptr;
+        for (Job* candidate : files) {
+            if (candidate->path == job.path) {
+                file = candidate;
+                break;
+            }
+        }
+        if (!file) {
+            files.push_back(&job);
+        } else {
+            file->bytes += job.bytes;
+            if (file->header.empty()) file->header = move(job.header);
+        }
+    }
+
+    SyncPolicy policy = currentPolicy();
+    bool sync = policy == SyncPolicy::EveryCommit || (policy == SyncPolicy::Periodic && syncIntervalElapsed());
+    int committed = 0;
+    for (Job* file : files) {
+        int fd = openFile(file->path, false);
+        bool ok = fd >= 0;
+        if (ok && !file->header.empty() && isEmptyFile(fd)) {
+            ok = writeAll(fd, file->header);
+        }
+        ok = ok && writeAll(fd, file->bytes);
+        if (ok && sync) {
+            ok = syncFile(fd);
+        }
+        if (fd >= 0) {
+            ok = closeFile(fd) && ok;
+        }
+        if (!ok) {
+            LOG_ERROR(logStorage) << "Unable to write " << file->path;
+            emit writeFailed(QString::fromStdString(file->path));
+            continue;
+        }
+        if (policy == SyncPolicy::Periodic && !sync) {
+            unsynced.insert(file->path);
+        }
+        ++committed;
+    }
+    if (sync) {
+        syncPending();
+    }
+    if (committed > 0) {
+        emit appendsCommitted(static_cast<int>(batch.size()));
+    }
+}
+
+bool PersistenceService::writeCatalog(const Job& job) {
+    SCOPED_LATENCY("PersistenceService::writeCatalog");
+    // Rotate the log so records queued after this save go to a fresh file
+    error_code ec;
+    if (filesystem::exists(job.rotatedLogPath, ec)) {
+        // The previous save didn't finish; keep its records ahead of ours
+        ifstream pending(job.logPath, ios::binary);
+        ofstream rotated(job.rotatedLogPath, ios::binary | ios::app);
+        rotated << pending.rdbuf();
+        pending.close();
+        rotated.close();
+        filesystem::remove(job.logPath, ec);
+    } else if (filesystem::exists(job.logPath, ec)) {
+        filesystem::rename(job.logPath, job.rotatedLogPath, ec);
+    }
+
+    // The rotated log is deleted below, so the snapshot must reach the disk
+    // first unless syncing is turned off altogether
+    SyncPolicy policy = currentPolicy();
+    string tempPath = job.path + ".tmp";
+    int fd = openFile(tempPath, true);
+    bool ok = fd >= 0 && writeAll(fd, job.bytes);
+    if (ok && policy != SyncPolicy::Never) {
+        ok = syncFile(fd);
+    }
+    if (fd >= 0) {
+        ok = closeFile(fd) && ok;
+    }
+    if (!ok) {
+        LOG_ERROR(logStorage) << "Unable to write " << tempPath;
+        emit writeFailed(QString::fromStdString(tempPath));
+        return false;
+    }
+    filesystem::rename(tempPath, job.path, ec);
+    if (ec) {
+        LOG_ERROR(logStorage) << "Unable to replace " << job.path;
+        emit writeFailed(QString::fromStdString(job.path));
+        return false;
+    }
+    filesystem::remove(job.rotatedLogPath, ec);
+    LOG_DEBUG(logStorage) << "Products saved to " << job.path;
+    return true;
+}
+
+PersistenceService::SyncPolicy PersistenceService::currentPolicy() {
+    lock_guard<mutex> guard(lock);
+    return syncPolicy;
+}
+
+bool PersistenceService::syncIntervalElapsed() {
+    lock_guard<mutex> guard(lock);
+    return chrono::steady_clock::now() - lastSync >= syncInterval;
+}
+
+void PersistenceService::syncPending() {
+    for (const string& path : unsynced) {
+        int fd = openFile(path, false);
+        if (fd < 0) continue;
+        syncFile(fd);
+        closeFile(fd);
+    }
+    unsynced.clear();
+    lastSync = chrono::steady_clock::now();
+}
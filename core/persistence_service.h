@@ -0,0 +1,86 @@
+#ifndef PERSISTENCE_SERVICE_H
+#define PERSISTENCE_SERVICE_H
+
+#include <QObject>
+#include <QString>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+// Moves all file writes off the GUI thread. Requests go into a bounded queue
+// served by one writer thread, in the order they were made:
+//   - appends to the same file are group-committed: everything queued when the
+//     writer wakes up is written with one open/write/sync per file
+//   - catalog saves are coalesced: a newer save replaces one still waiting
+// When the queue is full the caller blocks until the writer catches up, so
+// writes are never dropped. Completion is reported through signals, which
+// reach GUI-thread receivers as queued connections.
+class PersistenceService : public QObject {
+    Q_OBJECT
+
+public:
+    enum class SyncPolicy {
+        Never,       // leave flushing to the operating system
+        EveryCommit, // fsync after every group commit and catalog save
+        Periodic     // fsync written files at most once per interval
+    };
+
+    explicit PersistenceService(size_t capacity = 1024, QObject* parent = nullptr);
+    // Writes everything still queued before returning
+    ~PersistenceService();
+    PersistenceService(const PersistenceService&) = delete;
+    PersistenceService& operator=(const PersistenceService&) = delete;
+
+    void setSyncPolicy(SyncPolicy policy, chrono::milliseconds interval = chrono::milliseconds(1000));
+
+    // Appends bytes to path; header is written first when the file is new
+    void append(const string& path, string bytes, const string& header = string());
+    // Replaces the catalog snapshot: moves logPath aside to rotatedLogPath,
+    // writes the snapshot through a temporary file, then drops the rotated log
+    void saveCatalog(const string& snapshotPath, const string& logPath, const string& rotatedLogPath, string snapshot);
+    // Blocks until everything queued so far has been written
+    void flush();
+
+signals:
+    void appendsCommitted(int records);
+    void catalogSaved(bool ok);
+    void writeFailed(const QString& path);
+
+private:
+    struct Job {
+        bool catalog;
+        string path;
+        string logPath;
+        string rotatedLogPath;
+        string bytes;
+        string header;
+    };
+
+    size_t capacity;
+    mutex lock;
+    condition_variable queued;
+    condition_variable drained;
+    deque<Job> jobs;
+    bool busy;
+    bool stopping;
+    SyncPolicy syncPolicy;
+    chrono::milliseconds syncInterval;
+    chrono::steady_clock::time_point lastSync;
+    set<string> unsynced; // files written since the last periodic sync
+    std::thread writer; // qualified: QObject::thread() hides the type in here
+
+    void run();
+    void commitAppends(deque<Job>& batch);
+    bool writeCatalog(const Job& job);
+    SyncPolicy currentPolicy();
+    bool syncIntervalElapsed();
+    void syncPending();
+};
+
+#endif // PERSISTENCE_SERVICE_H
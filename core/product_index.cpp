@@ -0,0 +1,236 @@
+#include "product_index.h"
+#include "fuzzy_match.h"
+#include "models.h"
+#include "taxonomy.h"
+#include <algorithm>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+using namespace std;
+
+static int lowestBit(uint64_t word) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+// SlotBitmap implementation
+void SlotBitmap::set(uint32_t slot) {
+    size_t index = slot / 64;
+    if (index >= words.size()) {
+        words.resize(index + 1, 0);
+        summary.resize(index / 64 + 1, 0);
+    }
+    uint64_t mask = uint64_t(1) << (slot % 64);
+    if (words[index] & mask) return;
+    words[index] |= mask;
+    summary[index / 64] |= uint64_t(1) << (index % 64);
+    ++cardinality;
+}
+
+void SlotBitmap::reset(uint32_t slot) {
+    size_t index = slot / 64;
+    uint64_t mask = uint64_t(1) << (slot % 64);
+    if (index >= words.size() || !(words[index] & mask)) return;
+    words[index] &= ~mask;
+    if (!words[index]) {
+        summary[index / 64] &= ~(uint64_t(1) << (index % 64));
+    }
+    --cardinality;
+}
+
+bool SlotBitmap::test(uint32_t slot) const {
+    return (word(slot / 64) >> (slot % 64)) & 1;
+}
+
+// ProductIndex implementation
+void ProductIndex::insert(ProductNode* node) {
+    uint32_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+        nodes[slot] = node;
+    } else {
+        slot = static_cast<uint32_t>(nodes.size());
+        nodes.push_back(node);
+    }
+    node->slot = slot;
+    bitmapFor(categoryIndex, node->product.category).set(slot);
+    bitmapFor(subCategoryIndex, node->product.subCategory).set(slot);
+    bitmapFor(skinTypeIndex, node->product.skinType).set(slot);
+    bitmapFor(rangeIndex, node->product.range).set(slot);
+    names.insert(slot, node->product.name);
+}
+
+void ProductIndex::erase(ProductNode* node) {
+    uint32_t slot = node->slot;
+    bitmapFor(categoryIndex, node->product.category).reset(slot);
+    bitmapFor(subCategoryIndex, node->product.subCategory).reset(slot);
+    bitmapFor(skinTypeIndex, node->product.skinType).reset(slot);
+    bitmapFor(rangeIndex, node->product.range).reset(slot);
+    names.erase(slot, node->product.name);
+    nodes[slot] = nullptr;
+    freeSlots.push_back(slot);
+}
+
+void ProductIndex::clear() {
+    categoryIndex.clear();
+    subCategoryIndex.clear();
+    skinTypeIndex.clear();
+    rangeIndex.clear();
+    names.clear();
+    nodes.clear();
+    freeSlots.clear();
+}
+
+size_t ProductIndex::memoryUsed() const {
+    size_t bytes = names.memoryUsed() + nodes.capacity() * sizeof(ProductNode*) + freeSlots.capacity() * sizeof(uint32_t);
+    for (const ValueIndex* index : {&categoryIndex, &subCategoryIndex, &skinTypeIndex, &rangeIndex}) {
+        bytes += index->capacity() * sizeof(SlotBitmap);
+        for (const SlotBitmap& bitmap : *index) bytes += bitmap.memoryUsed();
+    }
+    return bytes;
+}
+
+SlotBitmap& ProductIndex::bitmapFor(ValueIndex& index, uint16_t id) {
+    if (id >= index.size()) index.resize(id + 1);
+    return index[id];
+}
+
+// Adds the OR of the bitmaps for the requested values as one term of the query.
+// Returns false when the attribute is constrained but nothing can match.
+bool ProductIndex::addTerm(const ValueIndex& index, const AttributeDictionary& dictionary, const vector<string>& values, vector<vector<const SlotBitmap*>>& terms) {
+    if (values.empty()) return true;
+    vector<const SlotBitmap*> bitmaps;
+    for (const string& value : values) {
+        int id = dictionary.find(value);
+        if (id >= 0 && static_cast<size_t>(id) < index.size() && index[id].count() > 0) {
+            bitmaps.push_back(&index[id]);
+        }
+    }
+    if (bitmaps.empty()) return false;
+    terms.push_back(bitmaps);
+    return true;
+}
+
+vector<ProductNode*> ProductIndex::query(const ProductFilter& filter) const {
+    vector<ProductNode*> results;
+    vector<vector<const SlotBitmap*>> terms;
+
+    const Taxonomy& taxonomy = Taxonomy::instance();
+    if (!addTerm(categoryIndex, taxonomy.categories, filter.categories, terms)) return results;
+    if (!addTerm(subCategoryIndex, taxonomy.subCategories, filter.subCategories, terms)) return results;
+    if (!addTerm(rangeIndex, taxonomy.ranges, filter.ranges, terms)) return results;
+
+    // "All" on either side of the skin type comparison matches everything
+    if (!filter.skinTypes.empty() && find(filter.skinTypes.begin(), filter.skinTypes.end(), "All") == filter.skinTypes.end()) {
+        vector<string> skinTypes = filter.skinTypes;
+        skinTypes.push_back("All");
+        if (!addTerm(skinTypeIndex, taxonomy.skinTypes, skinTypes, terms)) return results;
+    }
+
+    if (terms.empty()) {
+        for (ProductNode* node : nodes) {
+            if (node) results.push_back(node);
+        }
+    } else {
+        // Drive the walk from the most selective term
+        auto termSize = [](const vector<const SlotBitmap*>& term) {
+            size_t total = 0;
+            for (const SlotBitmap* bitmap : term) total += bitmap->count();
+            return total;
+        };
+        sort(terms.begin(), terms.end(), [&](const vector<const SlotBitmap*>& a, const vector<const SlotBitmap*>& b) {
+            return termSize(a) < termSize(b);
+        });
+        const vector<const SlotBitmap*>& driver = terms.front();
+        size_t summaryWords = 0;
+        for (const SlotBitmap* bitmap : driver) summaryWords = max(summaryWords, bitmap->summarySize());
+
+        for (size_t s = 0; s < summaryWords; ++s) {
+            uint64_t present = 0;
+            for (const SlotBitmap* bitmap : driver) present |= bitmap->summaryWord(s);
+            while (present) {
+                size_t w = s * 64 + lowestBit(present);
+                present &= present - 1;
+
+                uint64_t bits = 0;
+                for (const SlotBitmap* bitmap : driver) bits |= bitmap->word(w);
+                for (size_t t = 1; t < terms.size() && bits; ++t) {
+                    uint64_t termBits = 0;
+                    for (const SlotBitmap* bitmap : terms[t]) termBits |= bitmap->word(w);
+                    bits &= termBits;
+                }
+                while (bits) {
+                    results.push_back(nodes[w * 64 + lowestBit(bits)]);
+                    bits &= bits - 1;
+                }
+            }
+        }
+    }
+
+    sort(results.begin(), results.end(), [](const ProductNode* a, const ProductNode* b) {
+        return a->product.code < b->product.code;
+    });
+    return results;
+}
+
+vector<NameHit> ProductIndex::matchName(NameMatcher& matcher) const {
+    vector<NameHit> hits;
+    auto check = [&](ProductNode* node) {
+        if (!node) return;
+        NameMatcher::Rank rank = matcher.rank(node->product.name);
+        if (rank != NameMatcher::NoMatch) hits.push_back({node, rank});
+    };
+    vector<uint32_t> candidates;
+    if (names.candidates(matcher, nodes.size() - freeSlots.size(), candidates)) {
+        for (uint32_t slot : candidates) check(nodes[slot]);
+    } else {
+        for (ProductNode* node : nodes) check(node);
+    }
+    return hits;
+}
+
+vector<ProductNode*> ProductIndex::searchName(string_view text, NameMatch mode, size_t limit) const {
+    NameMatcher matcher(text, mode);
+    vector<NameHit> hits = matchName(matcher);
+    auto better = [](const NameHit& a, const NameHit& b) {
+        return a.rank != b.rank ? a.rank < b.rank : a.node->product.code < b.node->product.code;
+    };
+    if (limit < hits.size()) {
+        partial_sort(hits.begin(), hits.begin() + limit, hits.end(), better);
+        hits.resize(limit);
+    } else {
+        sort(hits.begin(), hits.end(), better);
+    }
+    vector<ProductNode*> results;
+    results.reserve(hits.size());
+    for (const NameHit& hit : hits) results.push_back(hit.node);
+    return results;
+}
+
+vector<ProductNode*> ProductIndex::fuzzySearch(string_view text, int maxDistance, size_t limit, const function<bool(const Product&)>& accept) const {
+    auto nameOf = [&](uint32_t slot) -> const string* {
+        ProductNode* node = nodes[slot];
+        if (!node || (accept && !accept(node->product))) return nullptr;
+        return &node->product.name;
+    };
+    // Ties are broken by code while picking the hits too, so which ones make
+    // the cut doesn't depend on slot history
+    auto byCode = [this](uint32_t a, uint32_t b) {
+        return nodes[a]->product.code < nodes[b]->product.code;
+    };
+    vector<FuzzyHit> hits = ::fuzzySearch(names, nodes.size(), nameOf, text, maxDistance, limit, byCode);
+    sort(hits.begin(), hits.end(), [&](const FuzzyHit& a, const FuzzyHit& b) {
+        return a.distance != b.distance ? a.distance < b.distance : byCode(a.slot, b.slot);
+    });
+    vector<ProductNode*> results;
+    results.reserve(hits.size());
+    for (const FuzzyHit& hit : hits) results.push_back(nodes[hit.slot]);
+    return results;
+}
@@ -0,0 +1,94 @@
+#ifndef PRODUCT_INDEX_H
+#define PRODUCT_INDEX_H
+
+#include "name_index.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct ProductNode;
+class AttributeDictionary;
+class Product;
+
+// Set of product slots stored as a dense bitset, plus a summary level with one
+// bit per non-empty 64-bit word so sparse sets can be walked without touching
+// every word.
+class SlotBitmap {
+public:
+    SlotBitmap() : cardinality(0) {}
+    void set(uint32_t slot);
+    void reset(uint32_t slot);
+    bool test(uint32_t slot) const;
+    size_t count() const { return cardinality; }
+    uint64_t word(size_t index) const { return index < words.size() ? words[index] : 0; }
+    uint64_t summaryWord(size_t index) const { return index < summary.size() ? summary[index] : 0; }
+    size_t summarySize() const { return summary.size(); }
+    // Heap bytes held by the bitset
+    size_t memoryUsed() const { return (words.capacity() + summary.capacity()) * sizeof(uint64_t); }
+
+private:
+    vector<uint64_t> words;
+    vector<uint64_t> summary;
+    size_t cardinality;
+};
+
+// Search filter for the catalog. Every attribute lists the accepted values
+// (multi-select is an OR); an empty list leaves that attribute unconstrained.
+// Products with skin type "All" match any skin type, and asking for "All"
+// matches every skin type.
+struct ProductFilter {
+    vector<string> categories;
+    vector<string> subCategories;
+    vector<string> skinTypes;
+    vector<string> ranges;
+};
+
+// A product whose name matched a NameMatcher, and how well
+struct NameHit {
+    ProductNode* node;
+    NameMatcher::Rank rank;
+};
+
+// Per-value bitmap indexes over category, subCategory, skinType and range,
+// addressed by Taxonomy id. Each product node gets a slot; a query ANDs the
+// (ORed) bitmaps of every constrained attribute, so its cost follows the
+// number of matches rather than the catalog size. Names are indexed by
+// trigram over the same slots.
+class ProductIndex {
+public:
+    void insert(ProductNode* node);
+    void erase(ProductNode* node);
+    void clear();
+    // Results are ordered by product code
+    vector<ProductNode*> query(const ProductFilter& filter) const;
+    // Every product whose name matches, in no particular order
+    vector<NameHit> matchName(NameMatcher& matcher) const;
+    // Up to limit products whose names match text, best match first and then
+    // by code
+    vector<ProductNode*> searchName(string_view text, NameMatch mode, size_t limit) const;
+    // Up to limit products whose names are within maxDistance edits of text
+    // (see fuzzySearch in fuzzy_match.h), closest first and then by code.
+    // Products accept rejects are skipped.
+    vector<ProductNode*> fuzzySearch(string_view text, int maxDistance, size_t limit, const function<bool(const Product&)>& accept = nullptr) const;
+    // Heap bytes held by the bitmaps, the name index and the slot table
+    size_t memoryUsed() const;
+
+private:
+    typedef vector<SlotBitmap> ValueIndex;
+
+    ValueIndex categoryIndex;
+    ValueIndex subCategoryIndex;
+    ValueIndex skinTypeIndex;
+    ValueIndex rangeIndex;
+    TrigramIndex names;
+    vector<ProductNode*> nodes;
+    vector<uint32_t> freeSlots;
+
+    static SlotBitmap& bitmapFor(ValueIndex& index, uint16_t id);
+    static bool addTerm(const ValueIndex& index, const AttributeDictionary& dictionary, const vector<string>& values, vector<vector<const SlotBitmap*>>& terms);
+};
+
+#endif // PRODUCT_INDEX_H
@@ -0,0 +1,76 @@
+#include "taxonomy.h"
+#include <algorithm>
+#include <mutex>
+
+using namespace std;
+
+// AttributeDictionary implementation
+AttributeDictionary::AttributeDictionary(size_t maxSize) : chunks((maxSize + chunkMask) >> chunkBits), count(1), maxSize(maxSize) {
+    chunks[0].reset(new string[chunkMask + 1]);
+    sortedIds.push_back(0);
+}
+
+vector<uint16_t>::const_iterator AttributeDictionary::lowerBound(string_view value) const {
+    return lower_bound(sortedIds.begin(), sortedIds.end(), value, [this](uint16_t id, string_view v) {
+        return string_view(name(id)) < v;
+    });
+}
+
+int AttributeDictionary::find(string_view value) const {
+    shared_lock<shared_mutex> guard(lock);
+    auto it = lowerBound(value);
+    if (it != sortedIds.end() && name(*it) == value) return *it;
+    return -1;
+}
+
+uint16_t AttributeDictionary::intern(string_view value) {
+    // Nearly every value is already known, and looking it up only needs
+    // the shared lock
+    int known = find(value);
+    if (known >= 0) return static_cast<uint16_t>(known);
+
+    unique_lock<shared_mutex> guard(lock);
+    auto it = lowerBound(value);
+    if (it != sortedIds.end() && name(*it) == value) return *it;
+    size_t id = count.load(memory_order_relaxed);
+    if (id >= maxSize) return 0;
+    unique_ptr<string[]>& chunk = chunks[id >> chunkBits];
+    if (!chunk) chunk.reset(new string[chunkMask + 1]);
+    chunk[id & chunkMask] = string(value);
+    sortedIds.insert(it, static_cast<uint16_t>(id));
+    count.store(id + 1, memory_order_release);
+    return static_cast<uint16_t>(id);
+}
+
+// Taxonomy implementation
+Taxonomy& Taxonomy::instance() {
+    static Taxonomy taxonomy;
+    return taxonomy;
+}
+
+Taxonomy::Taxonomy()
+    : categories(UINT8_MAX + 1), subCategories(UINT16_MAX + 1), skinTypes(UINT8_MAX + 1), ranges(UINT8_MAX + 1) {
+    categoryList = {"Skincare", "Haircare", "Makeup"};
+    subCategoryLists = {
+        {"Cleansers", "Exfoliants", "Toners", "Serums", "Moisturizers", "Sunscreens", "Eye Creams", "Face Masks", "Spot Treatments", "Facial Oils", "Essences", "Face Mists", "Lip Care", "Anti-Aging Products", "Acne Treatments", "Brightening Products"},
+        {"Shampoo", "Conditioner", "Hair Oil", "Hair Mask", "Hair Serum", "Hair Spray", "Hair Mousse", "Hair Gel", "Leave-In Conditioner", "Hair Cream", "Hair Wax", "Hair Foam", "Hair Balm", "Hair Treatment", "Dry Shampoo", "Heat Protectant", "Hair Toner", "Hair Detangler", "Scalp Scrub", "Hair Fragrance"},
+        {"Foundation", "Concealer", "Powder", "Blush", "Bronzer", "Highlighter", "Contour", "Primer", "Eyeshadow", "Eyeliner", "Mascara", "Eyebrow Pencil", "Eyebrow Gel", "Lipstick", "Lip Gloss", "Lip Liner", "Lip Balm", "Setting Spray", "Setting Powder", "BB Cream", "CC Cream", "Tinted Moisturizer", "Eyelash Curler", "Face Mist", "Makeup Remover", "Eyebrow Powder", "Lip Stain", "Eyeshadow Primer", "Lip Plumper", "Color Corrector"}
+    };
+    skinTypeList = {"Oily", "Dry", "Combination", "Sensitive", "All"};
+    rangeList = {"Low", "Medium", "High"};
+
+    for (const string& category : categoryList) categories.intern(category);
+    for (const vector<string>& list : subCategoryLists) {
+        for (const string& subCategory : list) subCategories.intern(subCategory);
+    }
+    for (const string& skinType : skinTypeList) skinTypes.intern(skinType);
+    for (const string& range : rangeList) ranges.intern(range);
+}
+
+const vector<string>& Taxonomy::subCategoryNames(string_view category) const {
+    static const vector<string> none;
+    for (size_t i = 0; i < categoryList.size(); ++i) {
+        if (categoryList[i] == category) return subCategoryLists[i];
+    }
+    return none;
+}
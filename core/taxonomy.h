@@ -0,0 +1,74 @@
+#ifndef TAXONOMY_H
+#define TAXONOMY_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+// Vocabulary of one product attribute, interning each value as a small id.
+// Id 0 is always the empty string, so a default Product has valid ids.
+// Safe to use from several threads: products are parsed on loader threads
+// while the GUI thread reads names. Names never move once added, so name()
+// takes no lock.
+class AttributeDictionary {
+public:
+    explicit AttributeDictionary(size_t maxSize);
+    AttributeDictionary(const AttributeDictionary&) = delete;
+    AttributeDictionary& operator=(const AttributeDictionary&) = delete;
+
+    // Returns the id of value, adding it when it is not known yet. Values past
+    // maxSize are mapped to the empty string.
+    uint16_t intern(string_view value);
+    // Returns -1 when value is not in the dictionary
+    int find(string_view value) const;
+    const string& name(uint16_t id) const { return chunks[id >> chunkBits][id & chunkMask]; }
+    size_t size() const { return count.load(memory_order_acquire); }
+
+private:
+    static constexpr int chunkBits = 8;
+    static constexpr size_t chunkMask = (size_t(1) << chunkBits) - 1;
+
+    // Names in fixed-size chunks allocated as needed; the chunk table is sized
+    // for maxSize up front so it never reallocates
+    vector<unique_ptr<string[]>> chunks;
+    atomic<size_t> count;
+    mutable shared_mutex lock; // guards sortedIds and adding names
+    vector<uint16_t> sortedIds; // ids ordered by name, for binary search
+    size_t maxSize;
+
+    // Position of value in sortedIds; the caller holds the lock
+    vector<uint16_t>::const_iterator lowerBound(string_view value) const;
+};
+
+// The closed category / subCategory / skinType / range taxonomy shared by the
+// product model, the search index and every product dialog.
+class Taxonomy {
+public:
+    static Taxonomy& instance();
+
+    AttributeDictionary categories;
+    AttributeDictionary subCategories;
+    AttributeDictionary skinTypes;
+    AttributeDictionary ranges;
+
+    const vector<string>& categoryNames() const { return categoryList; }
+    const vector<string>& subCategoryNames(string_view category) const;
+    const vector<string>& skinTypeNames() const { return skinTypeList; }
+    const vector<string>& rangeNames() const { return rangeList; }
+
+private:
+    Taxonomy();
+
+    vector<string> categoryList;
+    vector<vector<string>> subCategoryLists; // parallel to categoryList
+    vector<string> skinTypeList;
+    vector<string> rangeList;
+};
+
+#endif // TAXONOMY_H
@@ -0,0 +1,161 @@
+#include "trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+atomic<bool> Trace::active(false);
+
+namespace {
+
+struct Span {
+    const char* name;
+    int64_t start;
+    int64_t end;
+};
+
+// One thread's spans. The lock is only contended while a trace is exported.
+struct Ring {
+    mutex lock;
+    vector<Span> spans; // allocated on the first span
+    size_t next = 0;
+    bool wrapped = false;
+    uint32_t threadId = 0;
+    string threadName;
+};
+
+struct Registry {
+    mutex lock;
+    vector<shared_ptr<Ring>> rings; // kept after their thread exits
+    uint32_t nextThreadId = 1;
+    int64_t startedAt = 0;
+};
+
+Registry& registry() {
+    static Registry* instance = new Registry; // threads may still record during exit
+    return *instance;
+}
+
+Ring& threadRing() {
+    thread_local shared_ptr<Ring> ring;
+    if (!ring) {
+        ring = make_shared<Ring>();
+        Registry& r = registry();
+        lock_guard<mutex> guard(r.lock);
+        ring->threadId = r.nextThreadId++;
+        r.rings.push_back(ring);
+    }
+    return *ring;
+}
+
+void appendEscaped(string& out, string_view text) {
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out += ' ';
+        } else {
+            out += c;
+        }
+    }
+}
+
+// Chrome timestamps are microseconds
+void appendMicroseconds(string& out, int64_t nanoseconds) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.3f", nanoseconds / 1000.0);
+    out += buffer;
+}
+
+}
+
+void Trace::start() {
+    Registry& r = registry();
+    {
+        lock_guard<mutex> guard(r.lock);
+        for (const shared_ptr<Ring>& ring : r.rings) {
+            lock_guard<mutex> ringGuard(ring->lock);
+            ring->next = 0;
+            ring->wrapped = false;
+        }
+        r.startedAt = now();
+    }
+    active.store(true, memory_order_relaxed);
+}
+
+void Trace::stop() {
+    active.store(false, memory_order_relaxed);
+}
+
+int64_t Trace::now() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Trace::record(const char* name, int64_t start, int64_t end) {
+    Ring& ring = threadRing();
+    lock_guard<mutex> guard(ring.lock);
+    if (ring.spans.empty()) ring.spans.resize(ringCapacity);
+    ring.spans[ring.next] = Span{name, start, end};
+    if (++ring.next == ringCapacity) {
+        ring.next = 0;
+        ring.wrapped = true;
+    }
+}
+
+void Trace::setThreadName(const string& name) {
+    Ring& ring = threadRing();
+    lock_guard<mutex> guard(ring.lock);
+    ring.threadName = name;
+}
+
+string Trace::chromeJson() {
+    Registry& r = registry();
+    lock_guard<mutex> guard(r.lock);
+    string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    auto separate = [&]() {
+        if (!first) out += ',';
+        first = false;
+        out += '\n';
+    };
+    for (const shared_ptr<Ring>& ring : r.rings) {
+        lock_guard<mutex> ringGuard(ring->lock);
+        string tid = to_string(ring->threadId);
+        separate();
+        out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + tid + ",\"args\":{\"name\":\"";
+        appendEscaped(out, ring->threadName.empty() ? "Thread " + tid : ring->threadName);
+        out += "\"}}";
+
+        size_t count = ring->wrapped ? ringCapacity : ring->next;
+        size_t oldest = ring->wrapped ? ring->next : 0;
+        for (size_t i = 0; i < count; ++i) {
+            const Span& span = ring->spans[(oldest + i) % ringCapacity];
+            // Spans still open when tracing started belong to the previous trace
+            if (span.start < r.startedAt) continue;
+            separate();
+            out += "{\"name\":\"";
+            appendEscaped(out, span.name);
+            out += "\",\"ph\":\"X\",\"pid\":1,\"tid\":" + tid + ",\"ts\":";
+            appendMicroseconds(out, span.start - r.startedAt);
+            out += ",\"dur\":";
+            appendMicroseconds(out, span.end - span.start);
+            out += '}';
+        }
+    }
+    out += "\n]}\n";
+    return out;
+}
+
+bool Trace::writeChromeJson(const string& path) {
+    ofstream file(path, ios::binary | ios::trunc);
+    file << chromeJson();
+    file.close();
+    return !file.fail();
+}
@@ -0,0 +1,58 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+// Span tracing in the Chrome trace-event format, viewable in Perfetto or
+// chrome://tracing. While tracing is off a span costs one relaxed atomic load.
+// While it is on, each thread records completed spans into its own ring
+// buffer, overwriting its oldest spans once the ring is full, so a long
+// session keeps its most recent history. Spans on one thread nest by time.
+// Every ScopedTimer (see metrics.h) is also a span; TRACE_SPAN marks extra
+// ones.
+class Trace {
+public:
+    static constexpr size_t ringCapacity = 65536; // spans kept per thread
+
+    static bool enabled() { return active.load(memory_order_relaxed); }
+    // Drops anything recorded before and starts recording
+    static void start();
+    static void stop();
+
+    // Nanoseconds on the steady clock, the time base of every span
+    static int64_t now();
+    // name must outlive the trace, e.g. a string literal
+    static void record(const char* name, int64_t start, int64_t end);
+    // Labels the calling thread in the trace
+    static void setThreadName(const string& name);
+
+    // Everything recorded so far as a Chrome trace-event JSON document
+    static string chromeJson();
+    static bool writeChromeJson(const string& path);
+
+private:
+    static atomic<bool> active;
+};
+
+// Records the enclosing scope as a span when tracing is on
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name) : name(name), start(Trace::enabled() ? Trace::now() : -1) {}
+    ~TraceSpan() {
+        if (start >= 0) Trace::record(name, start, Trace::now());
+    }
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name;
+    int64_t start;
+};
+
+#define TRACE_SPAN(name) TraceSpan traceSpan(name)
+
+#endif // TRACE_H
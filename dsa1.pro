@@ -1,26 +1,23 @@
-QT       += core gui
+# core: the catalog engine (domain model, indexes, storage), QtCore only
+# app:  the Qt Widgets front end, linked against core
+TEMPLATE = subdirs
 
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+SUBDIRS += \
+    core \
+    app \
+    catalog_bench \
+    dataset_gen \
+    fuzzy_bench \
+    storage_test \
+    ui_harness
 
-CONFIG += c++17
-
-# You can make your code fail to compile if it uses deprecated APIs.
-# In order to do so, uncomment the following line.
-#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
-
-SOURCES += \
-    identify_skin_type.cpp \
-    main.cpp \
-    mainwindow.cpp
-
-HEADERS += \
-    identify_skin_type.h \
-    mainwindow.h
-
-FORMS += \
-    mainwindow.ui
-
-# Default rules for deployment.
-qnx: target.path = /tmp/$${TARGET}/bin
-else: unix:!android: target.path = /opt/$${TARGET}/bin
-!isEmpty(target.path): INSTALLS += target
+app.depends = core
+catalog_bench.file = bench/catalog_bench.pro
+catalog_bench.depends = core
+dataset_gen.file = bench/dataset_gen.pro
+dataset_gen.depends = core
+fuzzy_bench.file = bench/fuzzy_bench.pro
+storage_test.file = tests/storage_test.pro
+storage_test.depends = core
+ui_harness.file = bench/ui_harness.pro
+ui_harness.depends = core
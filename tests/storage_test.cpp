@@ -0,0 +1,217 @@
+// Crash recovery of the storage files: a process killed mid-append leaves a
+// torn record at the end of a log, and the next session must neither apply
+// it nor lose what it appends after it.
+
+#include "catalog_log.h"
+#include "models.h"
+#include "order_log.h"
+#include "persistence_service.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QtTest>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+using namespace std;
+
+namespace {
+
+Product testProduct(int code, int quantity) {
+    return Product(code, "Product " + to_string(code), "Skincare", "Serums", "Oily", "Low", 9.5, quantity);
+}
+
+Order testOrder(const string& customer) {
+    return Order(customer, "1 Main Street", "03001234567", "test@example.com", {testProduct(1, 2), testProduct(2, 1)});
+}
+
+// The first size bytes of order's frame, as a crash mid-append leaves them
+string tornFrame(const Order& order, size_t size) {
+    return OrderLogWriter::frame(order).substr(0, size);
+}
+
+QStringList readCustomers(const string& path, bool* corrupt = nullptr) {
+    QStringList customers;
+    OrderLogReader reader(path);
+    Order order;
+    while (reader.next(order)) {
+        customers << QString::fromStdString(order.customerName);
+    }
+    if (corrupt) *corrupt = reader.corrupt();
+    return customers;
+}
+
+void appendBytes(const string& path, const string& bytes) {
+    ofstream file(path, ios::binary | ios::app);
+    file << bytes;
+}
+
+qint64 fileSize(const string& path) {
+    return QFileInfo(QString::fromStdString(path)).size();
+}
+
+}
+
+class StorageTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void catalogLogDropsTornTail_data();
+    void catalogLogDropsTornTail();
+    void orderLogSkipsTornRecord_data();
+    void orderLogSkipsTornRecord();
+    void orderLogTruncatesTornTail();
+    void orderLogResyncsPastLongTail();
+    void orderLogReadsUpToLimit();
+
+private:
+    QTemporaryDir directory;
+
+    string path(const char* name) const { return QDir(directory.path()).filePath(name).toStdString(); }
+};
+
+void StorageTest::catalogLogDropsTornTail_data() {
+    QTest::addColumn<QString>("torn");
+    QTest::newRow("quantity") << "Q,1234,4"; // Q,1234,45 cut short
+    QTest::newRow("delete") << "D,12";       // D,1234 cut short
+    QTest::newRow("add") << "A,77,Product 77,Skin";
+}
+
+void StorageTest::catalogLogDropsTornTail() {
+    QFETCH(QString, torn);
+    string snapshot = path("products.bin");
+    string log = path("products.log");
+    string text = path("products.txt");
+    remove(log.c_str());
+    {
+        PersistenceService persistence;
+        CatalogLog catalog(persistence, snapshot, log, text);
+        ProductBST products;
+        catalog.load(products);
+        catalog.recordAdd(testProduct(1234, 5));
+        catalog.recordAdd(testProduct(12, 7));
+        catalog.recordQuantity(1234, 45);
+        persistence.flush();
+    }
+    qint64 intact = fileSize(log);
+    appendBytes(log, torn.toStdString());
+
+    {
+        PersistenceService persistence;
+        CatalogLog catalog(persistence, snapshot, log, text);
+        ProductBST products;
+        catalog.load(products);
+        QCOMPARE(products.size(), size_t(2));
+        QCOMPARE(products.findProduct(1234)->quantity, 45);
+        QCOMPARE(products.findProduct(12)->quantity, 7);
+        QCOMPARE(fileSize(log), intact);
+        catalog.recordQuantity(12, 9);
+        persistence.flush();
+    }
+
+    // The record appended after the torn one is read back whole
+    PersistenceService persistence;
+    CatalogLog catalog(persistence, snapshot, log, text);
+    ProductBST products;
+    catalog.load(products);
+    QCOMPARE(products.size(), size_t(2));
+    QCOMPARE(products.findProduct(1234)->quantity, 45);
+    QCOMPARE(products.findProduct(12)->quantity, 9);
+}
+
+void StorageTest::orderLogSkipsTornRecord_data() {
+    QTest::addColumn<int>("tornSize");
+    QTest::newRow("length only") << 3;
+    QTest::newRow("frame header") << 8;
+    QTest::newRow("half the payload") << 60;
+}
+
+// A crash tore the second order; later sessions appended two more after it
+void StorageTest::orderLogSkipsTornRecord() {
+    QFETCH(int, tornSize);
+    string log = path("orders.log");
+    remove(log.c_str());
+    appendBytes(log, OrderLogWriter::header() + OrderLogWriter::frame(testOrder("A")) + tornFrame(testOrder("B"), tornSize));
+    QVERIFY(OrderLogWriter::append(log, testOrder("C")));
+    QVERIFY(OrderLogWriter::append(log, testOrder("D")));
+
+    bool corrupt = false;
+    QCOMPARE(readCustomers(log, &corrupt), QStringList({"A", "C", "D"}));
+    QVERIFY(corrupt);
+
+    // Intact records follow the damage, so there is no tail to cut off
+    qint64 size = fileSize(log);
+    OrderLogReader reader(log);
+    Order order;
+    while (reader.next(order)) {
+    }
+    QVERIFY(!reader.truncateTornTail());
+    QCOMPARE(fileSize(log), size);
+}
+
+void StorageTest::orderLogTruncatesTornTail() {
+    string log = path("orders.log");
+    remove(log.c_str());
+    appendBytes(log, OrderLogWriter::header() + OrderLogWriter::frame(testOrder("A")));
+    qint64 intact = fileSize(log);
+    appendBytes(log, tornFrame(testOrder("B"), 60));
+
+    OrderLogReader reader(log);
+    Order order;
+    QVERIFY(reader.next(order));
+    QVERIFY(!reader.next(order));
+    QVERIFY(reader.corrupt());
+    QVERIFY(reader.truncateTornTail());
+    QCOMPARE(fileSize(log), intact);
+
+    QVERIFY(OrderLogWriter::append(log, testOrder("C")));
+    bool corrupt = true;
+    QCOMPARE(readCustomers(log, &corrupt), QStringList({"A", "C"}));
+    QVERIFY(!corrupt);
+}
+
+// The damage is followed by far more than one resync window, starting with
+// an order whose frame is longer than a window on its own
+void StorageTest::orderLogResyncsPastLongTail() {
+    string log = path("orders.log");
+    remove(log.c_str());
+    vector<Product> cart;
+    for (int code = 1; code <= 2000; ++code) cart.push_back(testProduct(code, 1));
+    Order large("Large", "1 Main Street", "03001234567", "test@example.com", cart);
+    QVERIFY(OrderLogWriter::frame(large).size() > 64 * 1024);
+    appendBytes(log, OrderLogWriter::header() + OrderLogWriter::frame(testOrder("A")) + tornFrame(testOrder("B"), 60));
+    QVERIFY(OrderLogWriter::append(log, large));
+    QStringList expected({"A", "Large"});
+    for (int i = 0; i < 1000; ++i) {
+        QString customer = QString::number(i);
+        QVERIFY(OrderLogWriter::append(log, testOrder(customer.toStdString())));
+        expected << customer;
+    }
+
+    bool corrupt = false;
+    QCOMPARE(readCustomers(log, &corrupt), expected);
+    QVERIFY(corrupt);
+}
+
+// Orders appended while the history loads are past the limit it recorded;
+// a torn tail before them must not be cut off with them
+void StorageTest::orderLogReadsUpToLimit() {
+    string log = path("orders.log");
+    remove(log.c_str());
+    appendBytes(log, OrderLogWriter::header() + OrderLogWriter::frame(testOrder("A")) + tornFrame(testOrder("B"), 60));
+    qint64 limit = fileSize(log);
+    QVERIFY(OrderLogWriter::append(log, testOrder("C")));
+
+    OrderLogReader reader(log, limit);
+    Order order;
+    QVERIFY(reader.next(order));
+    QCOMPARE(order.customerName, string("A"));
+    QVERIFY(!reader.next(order));
+    QVERIFY(reader.corrupt());
+    QVERIFY(!reader.truncateTornTail());
+    QCOMPARE(readCustomers(log), QStringList({"A", "C"}));
+}
+
+QTEST_GUILESS_MAIN(StorageTest)
+#include "storage_test.moc"
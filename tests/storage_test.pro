@@ -0,0 +1,13 @@
+# Crash recovery tests for the catalog log and the order log.
+#   qmake && make check
+
+TEMPLATE = app
+TARGET = storage_test
+CONFIG += console c++17 testcase
+CONFIG -= app_bundle
+QT = core testlib
+
+include(../core/core.pri)
+
+SOURCES += \
+    storage_test.cpp